@@ -115,9 +115,9 @@ def generate_blobs_data(n_samples=500, n_features=10, centers=3, random_state=42
 
 
 def save_to_csv(X, y, output_dir=None, filename='input_data.csv', 
-                labels_filename='labels.csv', use_timestamp=False):
+                labels_filename='labels.csv', use_timestamp=False, data_format='csv'):
     """
-    Guarda los datos en formato CSV.
+    Guarda los datos en formato CSV (o .npy binario).
     
     Parámetros:
     -----------
@@ -133,6 +133,9 @@ def save_to_csv(X, y, output_dir=None, filename='input_data.csv',
         Nombre del archivo para las etiquetas
     use_timestamp : bool
         Si es True, agrega timestamp a los nombres de archivo
+    data_format : str
+        'csv' (texto) o 'npy' (binario de NumPy, float64 en orden C, que el
+        programa en C mapea sin copiar). Las etiquetas siempre van en CSV.
     """
     # Usar DATA_DIR por defecto
     if output_dir is None:
@@ -143,11 +146,15 @@ def save_to_csv(X, y, output_dir=None, filename='input_data.csv',
     # Crear directorio si no existe
     output_dir.mkdir(parents=True, exist_ok=True)
     
+    # Extensión según el formato de los datos
+    extension = f'.{data_format}'
+    filename = filename.replace('.csv', extension)
+    
     # Agregar timestamp si es necesario
     if use_timestamp:
         timestamp = datetime.now().strftime("%Y%m%d_%H%M%S")
-        base_name = filename.replace('.csv', '')
-        filename = f"{base_name}_{timestamp}.csv"
+        base_name = filename.replace(extension, '')
+        filename = f"{base_name}_{timestamp}{extension}"
         
         base_labels = labels_filename.replace('.csv', '')
         labels_filename = f"{base_labels}_{timestamp}.csv"
@@ -158,33 +165,41 @@ def save_to_csv(X, y, output_dir=None, filename='input_data.csv',
     
     # Guardar datos (sin encabezados, solo valores numéricos)
     # Formato: cada fila es una muestra, cada columna es una dimensión
-    np.savetxt(filepath, X, delimiter=',', fmt='%.6f')
-    print(f"\n✓ Datos guardados en: {filepath}")
-    print(f"  - Formato: CSV sin encabezados")
+    if data_format == 'npy':
+        np.save(filepath, np.ascontiguousarray(X, dtype=np.float64))
+        print(f"\n✓ Datos guardados en: {filepath}")
+        print(f"  - Formato: .npy (float64, orden C)")
+    else:
+        np.savetxt(filepath, X, delimiter=',', fmt='%.6f')
+        print(f"\n✓ Datos guardados en: {filepath}")
+        print(f"  - Formato: CSV sin encabezados")
     print(f"  - Dimensiones: {X.shape[0]} filas x {X.shape[1]} columnas")
     
     # Guardar etiquetas por separado (para validación)
     np.savetxt(labels_filepath, y, delimiter=',', fmt='%d')
     print(f"✓ Etiquetas guardadas en: {labels_filepath}")
     
-    # También guardar una versión con pandas para inspección
-    df = pd.DataFrame(X, columns=[f'dim_{i}' for i in range(X.shape[1])])
-    df['label'] = y
-    
-    if use_timestamp:
-        info_filename = f'input_data_with_labels_{timestamp}.csv'
-    else:
-        info_filename = 'input_data_with_labels.csv'
-    
-    info_filepath = output_dir / info_filename
-    df.to_csv(info_filepath, index=False)
-    print(f"✓ Datos con etiquetas (para inspección): {info_filepath}")
+    # También guardar una versión con pandas para inspección (solo en CSV:
+    # con .npy se evita formatear texto para datasets grandes)
+    info_filepath = None
+    if data_format == 'csv':
+        df = pd.DataFrame(X, columns=[f'dim_{i}' for i in range(X.shape[1])])
+        df['label'] = y
+        
+        if use_timestamp:
+            info_filename = f'input_data_with_labels_{timestamp}.csv'
+        else:
+            info_filename = 'input_data_with_labels.csv'
+        
+        info_filepath = output_dir / info_filename
+        df.to_csv(info_filepath, index=False)
+        print(f"✓ Datos con etiquetas (para inspección): {info_filepath}")
     
     # Solo crear enlaces si se usa timestamp (de lo contrario, los archivos ya son los "latest")
     if use_timestamp:
         # Siempre crear/actualizar enlaces simbólicos a los archivos más recientes
         # Esto permite que el programa en C siempre use los últimos datos
-        latest_input = output_dir / 'input_data.csv'
+        latest_input = output_dir / f'input_data{extension}'
         latest_labels = output_dir / 'labels.csv'
         latest_with_labels = output_dir / 'input_data_with_labels.csv'
         
@@ -192,7 +207,8 @@ def save_to_csv(X, y, output_dir=None, filename='input_data.csv',
         import shutil
         shutil.copy2(filepath, latest_input)
         shutil.copy2(labels_filepath, latest_labels)
-        shutil.copy2(info_filepath, latest_with_labels)
+        if info_filepath is not None:
+            shutil.copy2(info_filepath, latest_with_labels)
         
         print(f"\n✓ Enlaces a archivos actuales actualizados:")
         print(f"  - {latest_input}")
@@ -231,6 +247,10 @@ def main():
         '--timestamp', action='store_true',
         help='Agregar timestamp a los nombres de archivo para no sobrescribir'
     )
+    parser.add_argument(
+        '--format', '-f', choices=['csv', 'npy'], default='csv',
+        help='Formato de los datos de entrada: csv o npy (default: csv)'
+    )
     
     args = parser.parse_args()
     
@@ -259,7 +279,8 @@ def main():
         )
     
     # Guardar datos con o sin timestamp
-    save_to_csv(X, y, output_dir=output_dir, use_timestamp=args.timestamp)
+    save_to_csv(X, y, output_dir=output_dir, use_timestamp=args.timestamp,
+                data_format=args.format)
 
     print("\n" + "✓ Generación completada exitosamente")
     print("=" * 60)
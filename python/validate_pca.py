@@ -28,10 +28,27 @@ plt.rcParams['figure.figsize'] = (14, 10)
 plt.rcParams['font.size'] = 10
 
 
-def load_data(data_dir=None):
+def load_matrix(path):
+    """
+    Carga una matriz desde CSV o .npy (según la extensión). Los .npy se
+    mapean en memoria en lugar de leerse completos.
+    """
+    if path.suffix == '.npy':
+        return np.load(path, mmap_mode='r')
+    return np.loadtxt(path, delimiter=',')
+
+
+def load_data(data_dir=None, data_format='csv'):
     """
     Carga los datos de entrada y salida.
     
+    Parameters:
+    -----------
+    data_dir : str or Path
+        Directorio de datos (si es None, usa DATA_DIR)
+    data_format : str
+        Formato de entrada/salida: 'csv' o 'npy'
+    
     Returns:
     --------
     X_input : numpy.ndarray
@@ -51,11 +68,11 @@ def load_data(data_dir=None):
     print("=" * 70)
     
     # Cargar datos de entrada
-    X_input = np.loadtxt(data_path / 'input_data.csv', delimiter=',')
+    X_input = load_matrix(data_path / f'input_data.{data_format}')
     print(f"✓ Datos de entrada cargados: {X_input.shape}")
     
     # Cargar datos proyectados por C
-    X_c = np.loadtxt(data_path / 'output_data.csv', delimiter=',')
+    X_c = load_matrix(data_path / f'output_data.{data_format}')
     print(f"✓ Datos de salida (C) cargados: {X_c.shape}")
     
     # Cargar etiquetas
@@ -560,6 +577,10 @@ def main():
         '--timestamp', action='store_true',
         help='Agregar timestamp a los nombres de archivo para no sobrescribir'
     )
+    parser.add_argument(
+        '--format', '-f', choices=['csv', 'npy'], default='csv',
+        help='Formato de input_data/output_data: csv o npy (default: csv)'
+    )
     
     args = parser.parse_args()
     
@@ -575,7 +596,7 @@ def main():
     
     try:
         # 1. Cargar datos
-        X_input, X_c, y = load_data()
+        X_input, X_c, y = load_data(data_format=args.format)
         
         # 2. Aplicar PCA con sklearn
         X_sklearn, pca_model = apply_sklearn_pca(X_input, n_components=X_c.shape[1])
@@ -4,7 +4,22 @@
  * This program reads data from a CSV file, applies PCA dimensionality
  * reduction, and writes the transformed data to an output CSV file.
  * 
- * Usage: ./pca_program [input_file] [output_file] [n_components] [timestamp]
+ * Usage: ./pca_program [options] [input_file] [output_file] [n_components] [timestamp]
+ * 
+ * Options:
+ *   --threads=N: worker threads for parallel kernels (0 = all cores)
+ *   --eigen=NAME: eigen solver backend (subspace, power, dense, lanczos)
+ *   --matrix-free: never form the covariance matrix (uses lanczos)
+ *   --solver=NAME: fitting strategy (covariance, randomized, svd)
+ *   --oversample=N, --power-iters=N: randomized SVD tuning
+ *   --arena: take all fit/transform scratch from one pre-sized arena
+ *   --precision=N: CSV output with N decimals (default: shortest round-trip)
+ *   --stream, --chunk-rows=N: out-of-core fit and transform of a CSV file
+ *     read N rows at a time (default: 65536)
+ * 
+ * Input and output files ending in .pcamat use the binary matrix format
+ * and files ending in .npy are NumPy arrays (both mapped without copying
+ * on input when the layout allows it); anything else is CSV.
  * 
  * Default values:
  *   input_file: data/input_data.csv
@@ -24,19 +39,88 @@
 #define DEFAULT_OUTPUT_FILE "data/output_data.csv"
 #define DEFAULT_K_COMPONENTS 2
 
+/* Files with these extensions use a binary format instead of CSV */
+#define BINARY_EXTENSION ".pcamat"
+#define NPY_EXTENSION ".npy"
+
 void print_usage(const char *program_name) {
-    printf("\nUsage: %s [input_file] [output_file] [n_components] [timestamp]\n", program_name);
+    printf("\nUsage: %s [options] [input_file] [output_file] [n_components] [timestamp]\n", program_name);
     printf("\nArguments:\n");
     printf("  input_file    : Path to input CSV file (default: %s)\n", DEFAULT_INPUT_FILE);
     printf("  output_file   : Path to output CSV file (default: %s)\n", DEFAULT_OUTPUT_FILE);
+    printf("                  Files ending in %s use the binary matrix format,\n", BINARY_EXTENSION);
+    printf("                  files ending in %s are NumPy arrays\n", NPY_EXTENSION);
     printf("  n_components  : Number of principal components (default: %d)\n", DEFAULT_K_COMPONENTS);
     printf("  timestamp     : Optional timestamp string to append to output filename\n");
+    printf("\nOptions:\n");
+    printf("  --threads=N   : Worker threads for parallel kernels (default: 0 = all cores)\n");
+    printf("  --eigen=NAME  : Eigen solver: subspace (default, block iteration),\n");
+    printf("                  power (one vector at a time), dense (Householder + QL)\n");
+    printf("                  or lanczos (thick-restart Lanczos)\n");
+    printf("  --matrix-free : Apply the covariance as X^T(X v) without forming it\n");
+    printf("                  (O(n*d) memory, uses the lanczos solver)\n");
+    printf("  --solver=NAME : Fitting strategy: covariance (default), randomized\n");
+    printf("                  or svd (TSQR + Jacobi SVD of the centered data)\n");
+    printf("  --oversample=N: Randomized SVD extra sketch columns (default: 10)\n");
+    printf("  --power-iters=N: Randomized SVD power iterations (default: 2)\n");
+    printf("  --arena       : Take fit/transform scratch from one pre-sized arena\n");
+    printf("  --precision=N : Write CSV values with N decimals (default: shortest\n");
+    printf("                  text that reads back to the same double)\n");
+    printf("  --stream      : Fit and transform a CSV input larger than memory,\n");
+    printf("                  one chunk of rows at a time (covariance solver only)\n");
+    printf("  --chunk-rows=N: Rows per chunk with --stream (default: %d)\n",
+           PCA_STREAM_CHUNK_ROWS);
     printf("\nExamples:\n");
     printf("  %s data/input_data.csv data/output_data.csv 3\n", program_name);
     printf("  %s data/input_data.csv data/output_data.csv 2 20241018_143025\n", program_name);
+    printf("  %s --threads=8 data/input_data.csv data/output_data.csv 3\n", program_name);
+    printf("  %s --stream --chunk-rows=100000 big.csv reduced.csv 10\n", program_name);
     printf("\n");
 }
 
+/* True if filename ends with the given extension */
+int has_extension(const char *filename, const char *extension) {
+    size_t len = strlen(filename);
+    size_t ext_len = strlen(extension);
+    return len >= ext_len && strcmp(filename + len - ext_len, extension) == 0;
+}
+
+/* Read input as a binary matrix, .npy or CSV, depending on the extension */
+Matrix* load_matrix(const char *filename, int n_threads) {
+    if (has_extension(filename, BINARY_EXTENSION)) {
+        return read_matrix_binary(filename);
+    }
+    if (has_extension(filename, NPY_EXTENSION)) {
+        return read_npy(filename);
+    }
+    return read_csv_parallel(filename, n_threads);
+}
+
+/* Write output as a binary matrix, .npy or CSV, depending on the extension */
+int save_matrix(const Matrix *mat, const char *filename, int precision, int n_threads) {
+    if (has_extension(filename, BINARY_EXTENSION)) {
+        return write_matrix_binary(mat, filename);
+    }
+    if (has_extension(filename, NPY_EXTENSION)) {
+        return write_npy(mat, filename);
+    }
+    return write_csv_parallel(mat, filename, precision, n_threads);
+}
+
+/* Parse a whole-number argument; returns -1 on trailing garbage or a fraction */
+int parse_int_arg(const char *text, int *value) {
+    double parsed;
+    const char *end = text + strlen(text);
+    const char *stop = pca_parse_double(text, end, &parsed);
+    
+    if (!stop || stop != end || parsed != floor(parsed) ||
+        parsed < -2147483648.0 || parsed > 2147483647.0) {
+        return -1;
+    }
+    *value = (int)parsed;
+    return 0;
+}
+
 void generate_timestamped_filename(const char *original_filename, const char *timestamp, char *output_filename) {
     /* Extract directory, base name, and extension */
     char *last_slash = strrchr(original_filename, '/');
@@ -87,6 +171,61 @@ void copy_file(const char *source, const char *destination) {
     if (dst) fclose(dst);
 }
 
+/*
+ * Out-of-core pipeline: the fit and the transform each read the CSV input
+ * in chunks, so neither the data nor the projection is ever held whole.
+ */
+int run_streaming(const char *input_file, const char *output_file, int n_components,
+                  const PCAOptions *options, int chunk_rows, int precision,
+                  size_t *rows, int *cols, double *explained) {
+    printf("========================================\n");
+    printf("Step 1: Opening Data\n");
+    printf("========================================\n");
+    
+    PCAChunkReader *reader = pca_chunk_reader_open(input_file, chunk_rows, options->n_threads);
+    if (!reader) {
+        print_error("Failed to read input file");
+        return -1;
+    }
+    
+    *cols = pca_chunk_reader_cols(reader);
+    printf("Data opened: %d features, %d rows per chunk\n", *cols, chunk_rows);
+    
+    if (n_components > *cols) {
+        printf("WARNING: n_components (%d) > n_features (%d)\n", n_components, *cols);
+        printf("Setting n_components = %d\n", *cols);
+        n_components = *cols;
+    }
+    
+    printf("\n========================================\n");
+    printf("Step 2: Fitting PCA Model (streaming)\n");
+    printf("========================================\n\n");
+    
+    PCAModel *model = pca_fit_stream(reader, n_components, options);
+    if (!model) {
+        print_error("Failed to fit PCA model");
+        pca_chunk_reader_close(reader);
+        return -1;
+    }
+    
+    printf("========================================\n");
+    printf("Step 3: Transforming and Writing Data (streaming)\n");
+    printf("========================================\n\n");
+    
+    int result = pca_transform_stream(model, reader, output_file, precision,
+                                      options->n_threads);
+    if (result != 0) {
+        print_error("Failed to transform data");
+    }
+    
+    *rows = pca_chunk_reader_rows(reader);
+    *explained = model->explained_variance_ratio;
+    
+    pca_chunk_reader_close(reader);
+    pca_free(model);
+    return result;
+}
+
 int main(int argc, char *argv[]) {
     /* Configuration */
     char input_file[MAX_FILENAME_LENGTH] = DEFAULT_INPUT_FILE;
@@ -95,6 +234,10 @@ int main(int argc, char *argv[]) {
     char *timestamp = NULL;
     int n_components = DEFAULT_K_COMPONENTS;
     int use_timestamp = 0;
+    int use_arena = 0;
+    int precision = -1;
+    int stream = 0;
+    int chunk_rows = PCA_STREAM_CHUNK_ROWS;
     
     /* Banner */
     printf("\n");
@@ -104,35 +247,105 @@ int main(int argc, char *argv[]) {
     printf("========================================\n");
     printf("\n");
     
-    /* Parse command line arguments */
-    if (argc > 1) {
-        if (strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "--help") == 0) {
+    /* Parse command line arguments: "--" options anywhere, the rest positional */
+    PCAOptions options = pca_default_options();
+    char *positional[4];
+    int n_positional = 0;
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
             print_usage(argv[0]);
             return 0;
+        } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            if (parse_int_arg(argv[i] + 10, &options.n_threads) != 0 ||
+                options.n_threads < 0) {
+                print_error("Number of threads must be a non-negative integer");
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--eigen=", 8) == 0) {
+            if (pca_eigen_solver_parse(argv[i] + 8, &options.eigen_solver) != 0) {
+                print_error("Unknown eigen solver");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--matrix-free") == 0) {
+            options.matrix_free = 1;
+        } else if (strncmp(argv[i], "--solver=", 9) == 0) {
+            if (pca_solver_parse(argv[i] + 9, &options.solver) != 0) {
+                print_error("Unknown solver");
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--oversample=", 13) == 0) {
+            if (parse_int_arg(argv[i] + 13, &options.oversample) != 0 ||
+                options.oversample < 0) {
+                print_error("Oversampling must be a non-negative integer");
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--power-iters=", 14) == 0) {
+            if (parse_int_arg(argv[i] + 14, &options.power_iterations) != 0 ||
+                options.power_iterations < 0) {
+                print_error("Power iterations must be a non-negative integer");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--arena") == 0) {
+            use_arena = 1;
+        } else if (strncmp(argv[i], "--precision=", 12) == 0) {
+            if (parse_int_arg(argv[i] + 12, &precision) != 0 ||
+                precision < 0 || precision > PCA_FORMAT_MAX_PRECISION) {
+                print_error("Precision must be an integer between 0 and 20");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--stream") == 0) {
+            stream = 1;
+        } else if (strncmp(argv[i], "--chunk-rows=", 13) == 0) {
+            if (parse_int_arg(argv[i] + 13, &chunk_rows) != 0 || chunk_rows <= 0) {
+                print_error("Chunk rows must be a positive integer");
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--", 2) == 0) {
+            print_error("Unknown option");
+            print_usage(argv[0]);
+            return 1;
+        } else if (n_positional < 4) {
+            positional[n_positional++] = argv[i];
         }
-        strncpy(input_file, argv[1], MAX_FILENAME_LENGTH - 1);
     }
     
-    if (argc > 2) {
-        strncpy(output_file, argv[2], MAX_FILENAME_LENGTH - 1);
+    if (n_positional > 0) {
+        strncpy(input_file, positional[0], MAX_FILENAME_LENGTH - 1);
+    }
+    
+    if (n_positional > 1) {
+        strncpy(output_file, positional[1], MAX_FILENAME_LENGTH - 1);
     }
     
-    if (argc > 3) {
-        n_components = atoi(argv[3]);
-        if (n_components <= 0) {
-            print_error("Number of components must be positive");
+    if (n_positional > 2) {
+        if (parse_int_arg(positional[2], &n_components) != 0 || n_components <= 0) {
+            print_error("Number of components must be a positive integer");
             return 1;
         }
     }
     
-    if (argc > 4) {
-        timestamp = argv[4];
+    if (n_positional > 3) {
+        timestamp = positional[3];
         use_timestamp = 1;
         generate_timestamped_filename(output_file, timestamp, timestamped_output_file);
     } else {
         strcpy(timestamped_output_file, output_file);
     }
     
+    /* Streaming reads and writes CSV through the covariance path only */
+    if (stream) {
+        if (has_extension(input_file, BINARY_EXTENSION) || has_extension(input_file, NPY_EXTENSION) ||
+            has_extension(output_file, BINARY_EXTENSION) || has_extension(output_file, NPY_EXTENSION)) {
+            print_error("--stream reads and writes CSV files");
+            return 1;
+        }
+        if (options.solver != PCA_SOLVER_COVARIANCE || options.matrix_free || use_arena) {
+            print_error("--stream supports only the covariance solver, without --matrix-free or --arena");
+            return 1;
+        }
+    }
+    
     /* Print configuration */
     printf("Configuration:\n");
     printf("  Input file:       %s\n", input_file);
@@ -143,14 +356,63 @@ int main(int argc, char *argv[]) {
         printf("  Output file:      %s\n", output_file);
     }
     printf("  Components (K):   %d\n", n_components);
+    printf("  Threads:          %d\n", resolve_thread_count(options.n_threads));
+    printf("  Solver:           %s\n", pca_solver_name(options.solver));
+    if (options.solver == PCA_SOLVER_RANDOMIZED) {
+        printf("  Oversampling:     %d\n", options.oversample);
+        printf("  Power iterations: %d\n", options.power_iterations);
+    } else if (options.solver == PCA_SOLVER_COVARIANCE) {
+        printf("  Eigen solver:     %s\n", pca_eigen_solver_name(options.eigen_solver));
+        printf("  Matrix-free:      %s\n", options.matrix_free ? "yes" : "no");
+    }
+    if (stream) {
+        printf("  Streaming:        %d rows per chunk\n", chunk_rows);
+    }
     printf("\n");
     
+    if (stream) {
+        size_t rows;
+        int cols;
+        double explained;
+        if (run_streaming(input_file, timestamped_output_file, n_components, &options,
+                          chunk_rows, precision, &rows, &cols, &explained) != 0) {
+            return 1;
+        }
+        
+        if (use_timestamp && strcmp(timestamped_output_file, output_file) != 0) {
+            printf("Creating link to latest version: %s\n", output_file);
+            copy_file(timestamped_output_file, output_file);
+        }
+        
+        if (n_components > cols) n_components = cols;
+        
+        printf("\n========================================\n");
+        printf("Summary\n");
+        printf("========================================\n");
+        printf("Original dimensions:      %zu x %d\n", rows, cols);
+        printf("Reduced dimensions:       %zu x %d\n", rows, n_components);
+        printf("Dimensionality reduction: %.1f%%\n",
+               (1.0 - (double)n_components / cols) * 100);
+        printf("Variance explained:       %.2f%%\n", explained * 100);
+        if (use_timestamp) {
+            printf("\nOutput saved to: %s\n", timestamped_output_file);
+            printf("Latest version:   %s\n", output_file);
+        } else {
+            printf("\nOutput saved to: %s\n", output_file);
+        }
+        
+        printf("\n========================================\n");
+        printf("PCA Completed Successfully!\n");
+        printf("========================================\n\n");
+        return 0;
+    }
+    
     /* Step 1: Read input data */
     printf("========================================\n");
     printf("Step 1: Loading Data\n");
     printf("========================================\n");
     
-    Matrix *data = read_csv(input_file);
+    Matrix *data = load_matrix(input_file, options.n_threads);
     if (!data) {
         print_error("Failed to read input file");
         return 1;
@@ -166,14 +428,30 @@ int main(int argc, char *argv[]) {
         n_components = data->cols;
     }
     
+    /* Scratch memory is known up front from the input dimensions */
+    size_t scratch_bytes = pca_scratch_bytes(data->rows, data->cols, n_components, &options);
+    printf("Scratch memory: %.2f MB%s\n", scratch_bytes / (1024.0 * 1024.0),
+           use_arena ? " (arena)" : "");
+    
+    PCAArena *arena = NULL;
+    if (use_arena) {
+        arena = pca_arena_create(scratch_bytes);
+        if (!arena) {
+            matrix_free(data);
+            return 1;
+        }
+        options.arena = arena;
+    }
+    
     /* Step 2: Fit PCA model */
     printf("\n========================================\n");
     printf("Step 2: Fitting PCA Model\n");
     printf("========================================\n\n");
     
-    PCAModel *model = pca_fit(data, n_components);
+    PCAModel *model = pca_fit_with_options(data, n_components, &options);
     if (!model) {
         print_error("Failed to fit PCA model");
+        pca_arena_free(arena);
         matrix_free(data);
         return 1;
     }
@@ -183,20 +461,12 @@ int main(int argc, char *argv[]) {
     printf("Step 3: Transforming Data\n");
     printf("========================================\n\n");
     
-    /* Re-read data (pca_fit modifies it by centering) */
-    Matrix *data_original = read_csv(input_file);
-    if (!data_original) {
-        print_error("Failed to re-read input file");
-        pca_free(model);
-        matrix_free(data);
-        return 1;
-    }
-    
-    Matrix *transformed = pca_transform(model, data_original);
-    matrix_free(data_original);
+    /* pca_fit leaves the input untouched, so the loaded data is reused */
+    Matrix *transformed = pca_transform_with_options(model, data, &options);
     
     if (!transformed) {
         print_error("Failed to transform data");
+        pca_arena_free(arena);
         pca_free(model);
         matrix_free(data);
         return 1;
@@ -210,8 +480,9 @@ int main(int argc, char *argv[]) {
     printf("Step 4: Writing Results\n");
     printf("========================================\n\n");
     
-    if (write_csv(transformed, timestamped_output_file) != 0) {
+    if (save_matrix(transformed, timestamped_output_file, precision, options.n_threads) != 0) {
         print_error("Failed to write output file");
+        pca_arena_free(arena);
         matrix_free(transformed);
         pca_free(model);
         matrix_free(data);
@@ -234,6 +505,10 @@ int main(int argc, char *argv[]) {
            (1.0 - (double)n_components / data->cols) * 100);
     printf("Variance explained:       %.2f%%\n", 
            model->explained_variance_ratio * 100);
+    if (arena) {
+        printf("Arena peak:               %.2f of %.2f MB\n",
+               arena->peak / (1024.0 * 1024.0), arena->capacity / (1024.0 * 1024.0));
+    }
     if (use_timestamp) {
         printf("\nOutput saved to: %s\n", timestamped_output_file);
         printf("Latest version:   %s\n", output_file);
@@ -246,6 +521,7 @@ int main(int argc, char *argv[]) {
     printf("========================================\n\n");
     
     /* Cleanup */
+    pca_arena_free(arena);
     matrix_free(data);
     matrix_free(transformed);
     pca_free(model);
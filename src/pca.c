@@ -10,62 +10,101 @@
  */
 
 #include "pca.h"
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <locale.h>
+#include <stdint.h>
+#include <errno.h>
+#include <limits.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && !defined(PCA_NO_SIMD)
+#define PCA_HAVE_X86_SIMD 1
+#include <immintrin.h>
+#endif
 
 /* ============================================
  * Matrix Operations Implementation
  * ============================================ */
 
-Matrix* matrix_create(int rows, int cols) {
-    if (rows <= 0 || cols <= 0) {
-        print_error("Invalid matrix dimensions");
-        return NULL;
-    }
-    
+/*
+ * Wrap an aligned buffer of rows x stride doubles in a Matrix, building
+ * the row pointer view. Takes ownership of values (freed on failure).
+ */
+static Matrix* matrix_wrap(double *values, int rows, int cols, int stride) {
     Matrix *mat = (Matrix*)malloc(sizeof(Matrix));
     if (!mat) {
         print_error("Failed to allocate matrix structure");
+        free(values);
         return NULL;
     }
     
+    mat->values = values;
     mat->rows = rows;
     mat->cols = cols;
+    mat->stride = stride;
+    mat->borrowed = 0;
+    mat->mapping = NULL;
+    mat->mapping_size = 0;
     
-    /* Allocate array of row pointers */
+    /* Build row pointer view into the buffer */
     mat->data = (double**)malloc(rows * sizeof(double*));
     if (!mat->data) {
         print_error("Failed to allocate matrix rows");
+        free(values);
         free(mat);
         return NULL;
     }
-    
-    /* Allocate each row */
     for (int i = 0; i < rows; i++) {
-        mat->data[i] = (double*)calloc(cols, sizeof(double));
-        if (!mat->data[i]) {
-            /* Free previously allocated rows */
-            for (int j = 0; j < i; j++) {
-                free(mat->data[j]);
-            }
-            free(mat->data);
-            free(mat);
-            print_error("Failed to allocate matrix row");
-            return NULL;
-        }
+        mat->data[i] = MATRIX_ROW(mat, i);
     }
     
     return mat;
 }
 
+/* Allocate an uninitialized MATRIX_ALIGNMENT-aligned array of doubles */
+static double* aligned_doubles(size_t count) {
+    void *buffer = NULL;
+    if (count == 0) count = 1;
+    if (posix_memalign(&buffer, MATRIX_ALIGNMENT, count * sizeof(double)) != 0) {
+        return NULL;
+    }
+    return (double*)buffer;
+}
+
+Matrix* matrix_create(int rows, int cols) {
+    if (rows <= 0 || cols <= 0) {
+        print_error("Invalid matrix dimensions");
+        return NULL;
+    }
+    
+    /* Allocate one aligned block for all elements */
+    size_t count = (size_t)rows * cols;
+    double *values = aligned_doubles(count);
+    if (!values) {
+        print_error("Failed to allocate matrix buffer");
+        return NULL;
+    }
+    memset(values, 0, count * sizeof(double));
+    
+    return matrix_wrap(values, rows, cols, cols);
+}
+
 void matrix_free(Matrix *mat) {
-    if (!mat) return;
+    if (!mat || mat->borrowed) return;
     
-    if (mat->data) {
-        for (int i = 0; i < mat->rows; i++) {
-            if (mat->data[i]) {
-                free(mat->data[i]);
-            }
-        }
-        free(mat->data);
+    if (mat->data) free(mat->data);
+    if (mat->mapping) {
+        munmap(mat->mapping, mat->mapping_size);
+    } else if (mat->values) {
+        free(mat->values);
     }
     free(mat);
 }
@@ -76,10 +115,14 @@ void matrix_copy(Matrix *dest, const Matrix *src) {
         return;
     }
     
+    if (dest->stride == src->stride) {
+        memcpy(dest->values, src->values,
+               (size_t)src->rows * src->stride * sizeof(double));
+        return;
+    }
+    
     for (int i = 0; i < src->rows; i++) {
-        for (int j = 0; j < src->cols; j++) {
-            dest->data[i][j] = src->data[i][j];
-        }
+        memcpy(MATRIX_ROW(dest, i), MATRIX_ROW(src, i), src->cols * sizeof(double));
     }
 }
 
@@ -111,14 +154,9 @@ Matrix* matrix_multiply(const Matrix *A, const Matrix *B) {
     Matrix *C = matrix_create(A->rows, B->cols);
     if (!C) return NULL;
     
-    for (int i = 0; i < A->rows; i++) {
-        for (int j = 0; j < B->cols; j++) {
-            double sum = 0.0;
-            for (int k = 0; k < A->cols; k++) {
-                sum += A->data[i][k] * B->data[k][j];
-            }
-            C->data[i][j] = sum;
-        }
+    if (matrix_gemm(A, B, C) != 0) {
+        matrix_free(C);
+        return NULL;
     }
     
     return C;
@@ -131,229 +169,3603 @@ Matrix* matrix_transpose(const Matrix *mat) {
     if (!trans) return NULL;
     
     for (int i = 0; i < mat->rows; i++) {
+        const double *row = MATRIX_ROW(mat, i);
         for (int j = 0; j < mat->cols; j++) {
-            trans->data[j][i] = mat->data[i][j];
+            MATRIX_ROW(trans, j)[i] = row[j];
         }
     }
     
     return trans;
 }
 
+double matrix_trace(const Matrix *mat) {
+    if (!mat) return 0.0;
+    
+    int n = (mat->rows < mat->cols) ? mat->rows : mat->cols;
+    double trace = 0.0;
+    for (int i = 0; i < n; i++) {
+        trace += MATRIX_ROW(mat, i)[i];
+    }
+    return trace;
+}
+
 /* ============================================
- * File I/O Operations Implementation
+ * Memory Arena Implementation
  * ============================================ */
 
-int get_csv_dimensions(const char *filename, int *rows, int *cols) {
-    FILE *file = fopen(filename, "r");
-    if (!file) {
-        print_error("Failed to open file for reading");
-        return -1;
+/* Round a byte count up to the arena alignment */
+static size_t arena_round(size_t bytes) {
+    return (bytes + MATRIX_ALIGNMENT - 1) & ~(size_t)(MATRIX_ALIGNMENT - 1);
+}
+
+PCAArena* pca_arena_create(size_t capacity) {
+    PCAArena *arena = (PCAArena*)calloc(1, sizeof(PCAArena));
+    if (!arena) {
+        print_error("Failed to allocate arena");
+        return NULL;
     }
     
-    char line[MAX_LINE_LENGTH];
-    *rows = 0;
-    *cols = 0;
-    
-    /* Count rows and columns */
-    while (fgets(line, sizeof(line), file)) {
-        (*rows)++;
-        
-        /* Count columns in first row */
-        if (*rows == 1) {
-            char *token = strtok(line, ",");
-            while (token != NULL) {
-                (*cols)++;
-                token = strtok(NULL, ",");
-            }
-        }
+    capacity = arena_round(capacity > 0 ? capacity : 1);
+    void *base = NULL;
+    if (posix_memalign(&base, MATRIX_ALIGNMENT, capacity) != 0) {
+        print_error("Failed to allocate arena region");
+        free(arena);
+        return NULL;
     }
     
-    fclose(file);
-    return 0;
+    arena->base = (unsigned char*)base;
+    arena->capacity = capacity;
+    return arena;
 }
 
-Matrix* read_csv(const char *filename) {
-    int rows, cols;
+void pca_arena_free(PCAArena *arena) {
+    if (!arena) return;
     
-    print_progress("Reading CSV file...");
+    free(arena->base);
+    free(arena);
+}
+
+void* pca_arena_alloc(PCAArena *arena, size_t bytes) {
+    if (!arena) return NULL;
     
-    /* Get dimensions */
-    if (get_csv_dimensions(filename, &rows, &cols) != 0) {
+    size_t size = arena_round(bytes > 0 ? bytes : 1);
+    if (size > arena->capacity - arena->used) {
+        print_error("Arena exhausted");
         return NULL;
     }
     
-    printf("  Detected %d rows x %d columns\n", rows, cols);
-    
-    /* Create matrix */
-    Matrix *mat = matrix_create(rows, cols);
-    if (!mat) return NULL;
-    
-    /* Open file again to read data */
-    FILE *file = fopen(filename, "r");
-    if (!file) {
-        matrix_free(mat);
-        print_error("Failed to open file for reading");
+    void *ptr = arena->base + arena->used;
+    arena->used += size;
+    if (arena->used > arena->peak) arena->peak = arena->used;
+    return ptr;
+}
+
+Matrix* pca_arena_matrix(PCAArena *arena, int rows, int cols) {
+    if (rows <= 0 || cols <= 0) {
+        print_error("Invalid matrix dimensions");
         return NULL;
     }
     
-    char line[MAX_LINE_LENGTH];
-    int row = 0;
-    
-    while (fgets(line, sizeof(line), file) && row < rows) {
-        int col = 0;
-        char *token = strtok(line, ",");
-        
-        while (token != NULL && col < cols) {
-            mat->data[row][col] = atof(token);
-            col++;
-            token = strtok(NULL, ",");
-        }
-        row++;
+    size_t mark = pca_arena_mark(arena);
+    size_t count = (size_t)rows * cols;
+    Matrix *mat = (Matrix*)pca_arena_alloc(arena, sizeof(Matrix));
+    double **row_view = (double**)pca_arena_alloc(arena, rows * sizeof(double*));
+    double *values = (double*)pca_arena_alloc(arena, count * sizeof(double));
+    if (!mat || !row_view || !values) {
+        pca_arena_release(arena, mark);
+        return NULL;
     }
+    memset(values, 0, count * sizeof(double));
     
-    fclose(file);
-    print_progress("CSV file loaded successfully");
+    mat->values = values;
+    mat->data = row_view;
+    mat->rows = rows;
+    mat->cols = cols;
+    mat->stride = cols;
+    mat->borrowed = 1;
+    mat->mapping = NULL;
+    mat->mapping_size = 0;
+    for (int i = 0; i < rows; i++) {
+        mat->data[i] = MATRIX_ROW(mat, i);
+    }
     
     return mat;
 }
 
-int write_csv(const Matrix *mat, const char *filename) {
-    if (!mat || !filename) return -1;
+size_t pca_arena_mark(const PCAArena *arena) {
+    return arena ? arena->used : 0;
+}
+
+void pca_arena_release(PCAArena *arena, size_t mark) {
+    if (arena && mark <= arena->used) arena->used = mark;
+}
+
+/* Arena bytes taken by pca_arena_matrix(rows, cols) */
+static size_t arena_matrix_bytes(int rows, int cols) {
+    return arena_round(sizeof(Matrix)) + arena_round(rows * sizeof(double*)) +
+           arena_round((size_t)rows * cols * sizeof(double));
+}
+
+/*
+ * Scratch helpers for the fit and transform paths: memory comes from the
+ * arena when one is given, from the heap otherwise. scratch_free is a
+ * no-op for arena memory, which is reclaimed in bulk by pca_arena_release.
+ */
+static void* scratch_alloc(PCAArena *arena, size_t bytes) {
+    return arena ? pca_arena_alloc(arena, bytes) : malloc(bytes);
+}
+
+static void* scratch_calloc(PCAArena *arena, size_t count, size_t size) {
+    if (!arena) return calloc(count, size);
     
-    print_progress("Writing results to CSV...");
+    void *ptr = pca_arena_alloc(arena, count * size);
+    if (ptr) memset(ptr, 0, count * size);
+    return ptr;
+}
+
+static void scratch_free(PCAArena *arena, void *ptr) {
+    if (!arena) free(ptr);
+}
+
+static Matrix* scratch_matrix(PCAArena *arena, int rows, int cols) {
+    return arena ? pca_arena_matrix(arena, rows, cols) : matrix_create(rows, cols);
+}
+
+/* ============================================
+ * Thread Helpers Implementation
+ * ============================================ */
+
+typedef void (*ParallelTask)(void *arg);
+
+typedef struct {
+    ParallelTask task;
+    void *arg;
+} ParallelThunk;
+
+static void* parallel_thunk(void *p) {
+    ParallelThunk *thunk = (ParallelThunk*)p;
+    thunk->task(thunk->arg);
+    return NULL;
+}
+
+/*
+ * Run task(args[i]) for i in [0, n_tasks), one task per thread. Task 0
+ * runs on the calling thread; if a thread cannot be created its task
+ * also runs inline, so every task always executes exactly once.
+ */
+static void parallel_run(int n_tasks, ParallelTask task, void *args, size_t arg_size) {
+    if (n_tasks <= 1) {
+        if (n_tasks == 1) task(args);
+        return;
+    }
     
-    FILE *file = fopen(filename, "w");
-    if (!file) {
-        print_error("Failed to open file for writing");
-        return -1;
+    pthread_t *threads = (pthread_t*)malloc(n_tasks * sizeof(pthread_t));
+    ParallelThunk *thunks = (ParallelThunk*)malloc(n_tasks * sizeof(ParallelThunk));
+    int *started = (int*)calloc(n_tasks, sizeof(int));
+    
+    for (int t = 1; t < n_tasks; t++) {
+        void *arg = (char*)args + (size_t)t * arg_size;
+        if (threads && thunks && started) {
+            thunks[t].task = task;
+            thunks[t].arg = arg;
+            started[t] = (pthread_create(&threads[t], NULL, parallel_thunk, &thunks[t]) == 0);
+        }
+        if (!started || !started[t]) {
+            task(arg);
+        }
     }
     
-    for (int i = 0; i < mat->rows; i++) {
-        for (int j = 0; j < mat->cols; j++) {
-            fprintf(file, "%.6f", mat->data[i][j]);
-            if (j < mat->cols - 1) {
-                fprintf(file, ",");
-            }
+    task(args);
+    
+    for (int t = 1; t < n_tasks; t++) {
+        if (started && started[t]) {
+            pthread_join(threads[t], NULL);
         }
-        fprintf(file, "\n");
     }
     
-    fclose(file);
-    printf("  Wrote %d rows x %d columns to %s\n", mat->rows, mat->cols, filename);
+    free(threads);
+    free(thunks);
+    free(started);
+}
+
+int resolve_thread_count(int requested) {
+    if (requested > 0) return requested;
     
-    return 0;
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    return (online > 0) ? (int)online : 1;
+}
+
+/* Minimum rows per thread before splitting is worth the extra partials */
+#define COVARIANCE_MIN_ROWS_PER_THREAD 256
+
+/* Threads for a pass that splits rows, capped so each gets enough rows */
+static int row_thread_count(int requested, int rows) {
+    int n_threads = resolve_thread_count(requested);
+    int max_threads = rows / COVARIANCE_MIN_ROWS_PER_THREAD;
+    if (n_threads > max_threads) n_threads = (max_threads > 0) ? max_threads : 1;
+    return n_threads;
 }
 
 /* ============================================
- * Statistical Operations Implementation
+ * GEMM Kernels Implementation
  * ============================================ */
 
-double* compute_mean(const Matrix *mat) {
-    if (!mat) return NULL;
+/*
+ * C += A * B is computed BLIS-style: B is packed in KC x NC panels of
+ * NR-wide column slivers, A in MC x KC blocks of MR-tall row slivers,
+ * and a register-tiled micro-kernel updates one MR x NR tile of C per
+ * call. Packing zero-pads the edges, so the micro-kernel always runs a
+ * full tile; partial tiles go through a small scratch tile.
+ */
+
+#define GEMM_MC 96
+#define GEMM_KC 256
+#define GEMM_NC 4096
+#define GEMM_MAX_TILE 128       /* Upper bound on MR * NR */
+
+typedef void (*GemmMicroKernel)(int kc, const double *a, const double *b,
+                                double *c, int ldc);
+
+typedef struct {
+    const char *name;
+    int mr;
+    int nr;
+    GemmMicroKernel kernel;
+} GemmKernel;
+
+static void gemm_micro_scalar(int kc, const double *a, const double *b,
+                              double *c, int ldc) {
+    double acc[4][4] = {{0.0}};
     
-    double *mean = (double*)calloc(mat->cols, sizeof(double));
-    if (!mean) {
-        print_error("Failed to allocate mean array");
-        return NULL;
+    for (int p = 0; p < kc; p++) {
+        for (int i = 0; i < 4; i++) {
+            for (int j = 0; j < 4; j++) {
+                acc[i][j] += a[i] * b[j];
+            }
+        }
+        a += 4;
+        b += 4;
     }
     
-    /* Sum each column */
-    for (int j = 0; j < mat->cols; j++) {
-        for (int i = 0; i < mat->rows; i++) {
-            mean[j] += mat->data[i][j];
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            c[i * ldc + j] += acc[i][j];
         }
-        mean[j] /= mat->rows;
+    }
+}
+
+#ifdef PCA_HAVE_X86_SIMD
+
+/* AVX2/FMA: 6 x 8 tile, 12 ymm accumulators */
+__attribute__((target("avx2,fma")))
+static void gemm_micro_avx2(int kc, const double *a, const double *b,
+                            double *c, int ldc) {
+    __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+    __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+    __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+    __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+    __m256d c40 = _mm256_setzero_pd(), c41 = _mm256_setzero_pd();
+    __m256d c50 = _mm256_setzero_pd(), c51 = _mm256_setzero_pd();
+    
+    for (int p = 0; p < kc; p++) {
+        __m256d b0 = _mm256_loadu_pd(b);
+        __m256d b1 = _mm256_loadu_pd(b + 4);
+        __m256d ai;
+        
+        ai = _mm256_broadcast_sd(a + 0);
+        c00 = _mm256_fmadd_pd(ai, b0, c00); c01 = _mm256_fmadd_pd(ai, b1, c01);
+        ai = _mm256_broadcast_sd(a + 1);
+        c10 = _mm256_fmadd_pd(ai, b0, c10); c11 = _mm256_fmadd_pd(ai, b1, c11);
+        ai = _mm256_broadcast_sd(a + 2);
+        c20 = _mm256_fmadd_pd(ai, b0, c20); c21 = _mm256_fmadd_pd(ai, b1, c21);
+        ai = _mm256_broadcast_sd(a + 3);
+        c30 = _mm256_fmadd_pd(ai, b0, c30); c31 = _mm256_fmadd_pd(ai, b1, c31);
+        ai = _mm256_broadcast_sd(a + 4);
+        c40 = _mm256_fmadd_pd(ai, b0, c40); c41 = _mm256_fmadd_pd(ai, b1, c41);
+        ai = _mm256_broadcast_sd(a + 5);
+        c50 = _mm256_fmadd_pd(ai, b0, c50); c51 = _mm256_fmadd_pd(ai, b1, c51);
+        
+        a += 6;
+        b += 8;
     }
     
-    return mean;
+#define GEMM_STORE_ROW_AVX2(i, lo, hi) \
+    _mm256_storeu_pd(c + (i) * ldc,     _mm256_add_pd(_mm256_loadu_pd(c + (i) * ldc), lo)); \
+    _mm256_storeu_pd(c + (i) * ldc + 4, _mm256_add_pd(_mm256_loadu_pd(c + (i) * ldc + 4), hi))
+    GEMM_STORE_ROW_AVX2(0, c00, c01);
+    GEMM_STORE_ROW_AVX2(1, c10, c11);
+    GEMM_STORE_ROW_AVX2(2, c20, c21);
+    GEMM_STORE_ROW_AVX2(3, c30, c31);
+    GEMM_STORE_ROW_AVX2(4, c40, c41);
+    GEMM_STORE_ROW_AVX2(5, c50, c51);
+#undef GEMM_STORE_ROW_AVX2
 }
 
-void center_data(Matrix *mat, const double *mean) {
-    if (!mat || !mean) return;
+/* AVX-512: 8 x 16 tile, 16 zmm accumulators */
+__attribute__((target("avx512f")))
+static void gemm_micro_avx512(int kc, const double *a, const double *b,
+                              double *c, int ldc) {
+    __m512d c00 = _mm512_setzero_pd(), c01 = _mm512_setzero_pd();
+    __m512d c10 = _mm512_setzero_pd(), c11 = _mm512_setzero_pd();
+    __m512d c20 = _mm512_setzero_pd(), c21 = _mm512_setzero_pd();
+    __m512d c30 = _mm512_setzero_pd(), c31 = _mm512_setzero_pd();
+    __m512d c40 = _mm512_setzero_pd(), c41 = _mm512_setzero_pd();
+    __m512d c50 = _mm512_setzero_pd(), c51 = _mm512_setzero_pd();
+    __m512d c60 = _mm512_setzero_pd(), c61 = _mm512_setzero_pd();
+    __m512d c70 = _mm512_setzero_pd(), c71 = _mm512_setzero_pd();
     
-    print_progress("Centering data (subtracting mean)...");
+    for (int p = 0; p < kc; p++) {
+        __m512d b0 = _mm512_loadu_pd(b);
+        __m512d b1 = _mm512_loadu_pd(b + 8);
+        __m512d ai;
+        
+        ai = _mm512_set1_pd(a[0]);
+        c00 = _mm512_fmadd_pd(ai, b0, c00); c01 = _mm512_fmadd_pd(ai, b1, c01);
+        ai = _mm512_set1_pd(a[1]);
+        c10 = _mm512_fmadd_pd(ai, b0, c10); c11 = _mm512_fmadd_pd(ai, b1, c11);
+        ai = _mm512_set1_pd(a[2]);
+        c20 = _mm512_fmadd_pd(ai, b0, c20); c21 = _mm512_fmadd_pd(ai, b1, c21);
+        ai = _mm512_set1_pd(a[3]);
+        c30 = _mm512_fmadd_pd(ai, b0, c30); c31 = _mm512_fmadd_pd(ai, b1, c31);
+        ai = _mm512_set1_pd(a[4]);
+        c40 = _mm512_fmadd_pd(ai, b0, c40); c41 = _mm512_fmadd_pd(ai, b1, c41);
+        ai = _mm512_set1_pd(a[5]);
+        c50 = _mm512_fmadd_pd(ai, b0, c50); c51 = _mm512_fmadd_pd(ai, b1, c51);
+        ai = _mm512_set1_pd(a[6]);
+        c60 = _mm512_fmadd_pd(ai, b0, c60); c61 = _mm512_fmadd_pd(ai, b1, c61);
+        ai = _mm512_set1_pd(a[7]);
+        c70 = _mm512_fmadd_pd(ai, b0, c70); c71 = _mm512_fmadd_pd(ai, b1, c71);
+        
+        a += 8;
+        b += 16;
+    }
     
-    for (int i = 0; i < mat->rows; i++) {
-        for (int j = 0; j < mat->cols; j++) {
-            mat->data[i][j] -= mean[j];
+#define GEMM_STORE_ROW_AVX512(i, lo, hi) \
+    _mm512_storeu_pd(c + (i) * ldc,     _mm512_add_pd(_mm512_loadu_pd(c + (i) * ldc), lo)); \
+    _mm512_storeu_pd(c + (i) * ldc + 8, _mm512_add_pd(_mm512_loadu_pd(c + (i) * ldc + 8), hi))
+    GEMM_STORE_ROW_AVX512(0, c00, c01);
+    GEMM_STORE_ROW_AVX512(1, c10, c11);
+    GEMM_STORE_ROW_AVX512(2, c20, c21);
+    GEMM_STORE_ROW_AVX512(3, c30, c31);
+    GEMM_STORE_ROW_AVX512(4, c40, c41);
+    GEMM_STORE_ROW_AVX512(5, c50, c51);
+    GEMM_STORE_ROW_AVX512(6, c60, c61);
+    GEMM_STORE_ROW_AVX512(7, c70, c71);
+#undef GEMM_STORE_ROW_AVX512
+}
+
+#endif /* PCA_HAVE_X86_SIMD */
+
+static const GemmKernel gemm_scalar_kernel = { "scalar", 4, 4, gemm_micro_scalar };
+#ifdef PCA_HAVE_X86_SIMD
+static const GemmKernel gemm_avx2_kernel = { "avx2", 6, 8, gemm_micro_avx2 };
+static const GemmKernel gemm_avx512_kernel = { "avx512", 8, 16, gemm_micro_avx512 };
+#endif
+
+/* Chosen once; the first caller may be any of the worker threads */
+static pthread_once_t gemm_kernel_once = PTHREAD_ONCE_INIT;
+static const GemmKernel *gemm_selected_kernel = &gemm_scalar_kernel;
+
+static void gemm_detect_kernel(void) {
+#ifdef PCA_HAVE_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        gemm_selected_kernel = &gemm_avx512_kernel;
+    } else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        gemm_selected_kernel = &gemm_avx2_kernel;
+    }
+#endif
+}
+
+static const GemmKernel *gemm_select_kernel(void) {
+    pthread_once(&gemm_kernel_once, gemm_detect_kernel);
+    return gemm_selected_kernel;
+}
+
+const char* gemm_kernel_name(void) {
+    return gemm_select_kernel()->name;
+}
+
+/*
+ * Pack an mc x kc block of op(A) into MR-tall slivers, zero-padding the
+ * edge. With trans_a set, op(A) = A^T and the block is read from kc rows
+ * of A, which lets X^T X stream X row by row without a transpose copy.
+ */
+static void gemm_pack_a(int mc, int kc, const double *A, int lda, int trans_a,
+                        int mr, double *pack) {
+    for (int i0 = 0; i0 < mc; i0 += mr) {
+        int rows = (mc - i0 < mr) ? mc - i0 : mr;
+        for (int p = 0; p < kc; p++) {
+            if (trans_a) {
+                const double *a_row = A + (size_t)p * lda + i0;
+                for (int i = 0; i < rows; i++) {
+                    pack[i] = a_row[i];
+                }
+            } else {
+                for (int i = 0; i < rows; i++) {
+                    pack[i] = A[(size_t)(i0 + i) * lda + p];
+                }
+            }
+            for (int i = rows; i < mr; i++) {
+                pack[i] = 0.0;
+            }
+            pack += mr;
         }
     }
 }
 
-Matrix* compute_covariance(const Matrix *mat) {
-    if (!mat) return NULL;
+/* Pack a kc x nc panel of B into NR-wide slivers, zero-padding the edge */
+static void gemm_pack_b(int kc, int nc, const double *B, int ldb,
+                        int nr, double *pack) {
+    for (int j0 = 0; j0 < nc; j0 += nr) {
+        int cols = (nc - j0 < nr) ? nc - j0 : nr;
+        for (int p = 0; p < kc; p++) {
+            const double *b_row = B + (size_t)p * ldb + j0;
+            for (int j = 0; j < cols; j++) {
+                pack[j] = b_row[j];
+            }
+            for (int j = cols; j < nr; j++) {
+                pack[j] = 0.0;
+            }
+            pack += nr;
+        }
+    }
+}
+
+/* Doubles of packing space for an m x n x k product: the A panel, padded
+ * to MATRIX_ALIGNMENT, followed by the B panel. *a_size gets the offset
+ * of the B panel when not NULL. */
+static size_t gemm_pack_size(int m, int n, int k, size_t *a_size) {
+    const GemmKernel *kern = gemm_select_kernel();
+    if (m <= 0 || n <= 0 || k <= 0) return 0;
     
-    print_progress("Computing covariance matrix...");
+    int kc_max = (k < GEMM_KC) ? k : GEMM_KC;
+    int nc_max = (n < GEMM_NC) ? n : GEMM_NC;
+    int mc_max = (m < GEMM_MC) ? m : GEMM_MC;
+    size_t a = (size_t)((mc_max + kern->mr - 1) / kern->mr) * kern->mr * kc_max;
+    size_t b = (size_t)((nc_max + kern->nr - 1) / kern->nr) * kern->nr * kc_max;
+    a = arena_round(a * sizeof(double)) / sizeof(double);
+    if (a_size) *a_size = a;
+    return a + b;
+}
+
+/*
+ * C (m x n) += op(A) (m x k) * B (k x n), all row-major with leading
+ * dimensions. op(A) is A, or A^T when trans_a is set (A is then k x m).
+ * With upper_only set, tiles lying entirely below the diagonal of C are
+ * skipped; entries below the diagonal inside diagonal tiles may still be
+ * written and must be ignored by the caller. pack holds
+ * gemm_pack_size(m, n, k) doubles, or is NULL to allocate the packing
+ * buffers for this call.
+ */
+static int gemm_driver(int m, int n, int k, const double *A, int lda, int trans_a,
+                       const double *B, int ldb, double *C, int ldc,
+                       int upper_only, double *pack) {
+    const GemmKernel *kern = gemm_select_kernel();
+    const int mr = kern->mr;
+    const int nr = kern->nr;
     
-    /* Covariance = (X^T * X) / (n - 1) */
-    Matrix *X_T = matrix_transpose(mat);
-    if (!X_T) return NULL;
+    if (m <= 0 || n <= 0 || k <= 0) return 0;
     
-    Matrix *cov = matrix_multiply(X_T, mat);
-    matrix_free(X_T);
+    size_t a_size;
+    size_t pack_size = gemm_pack_size(m, n, k, &a_size);
+    double *owned = NULL;
+    if (!pack) {
+        owned = aligned_doubles(pack_size);
+        if (!owned) return -1;
+        pack = owned;
+    }
+    double *a_pack = pack;
+    double *b_pack = pack + a_size;
+    double tile[GEMM_MAX_TILE];
     
-    if (!cov) return NULL;
+    for (int jc = 0; jc < n; jc += GEMM_NC) {
+        int nc = (n - jc < GEMM_NC) ? n - jc : GEMM_NC;
+        
+        for (int pc = 0; pc < k; pc += GEMM_KC) {
+            int kc = (k - pc < GEMM_KC) ? k - pc : GEMM_KC;
+            gemm_pack_b(kc, nc, B + (size_t)pc * ldb + jc, ldb, nr, b_pack);
+            
+            for (int ic = 0; ic < m; ic += GEMM_MC) {
+                int mc = (m - ic < GEMM_MC) ? m - ic : GEMM_MC;
+                
+                /* Whole row block below the diagonal */
+                if (upper_only && ic > jc + nc - 1) break;
+                
+                const double *a_block = trans_a ? A + (size_t)pc * lda + ic
+                                                : A + (size_t)ic * lda + pc;
+                gemm_pack_a(mc, kc, a_block, lda, trans_a, mr, a_pack);
+                
+                for (int jr = 0; jr < nc; jr += nr) {
+                    int n_eff = (nc - jr < nr) ? nc - jr : nr;
+                    const double *b_sliver = b_pack + (size_t)(jr / nr) * nr * kc;
+                    
+                    for (int ir = 0; ir < mc; ir += mr) {
+                        int m_eff = (mc - ir < mr) ? mc - ir : mr;
+                        
+                        /* Tile entirely below the diagonal */
+                        if (upper_only && ic + ir > jc + jr + n_eff - 1) break;
+                        
+                        const double *a_sliver = a_pack + (size_t)(ir / mr) * mr * kc;
+                        double *c_tile = C + (size_t)(ic + ir) * ldc + jc + jr;
+                        
+                        if (m_eff == mr && n_eff == nr) {
+                            kern->kernel(kc, a_sliver, b_sliver, c_tile, ldc);
+                            continue;
+                        }
+                        
+                        /* Edge tile: compute into scratch, then add the valid part */
+                        memset(tile, 0, (size_t)mr * nr * sizeof(double));
+                        kern->kernel(kc, a_sliver, b_sliver, tile, nr);
+                        for (int i = 0; i < m_eff; i++) {
+                            for (int j = 0; j < n_eff; j++) {
+                                c_tile[(size_t)i * ldc + j] += tile[i * nr + j];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
     
-    /* Divide by (n - 1) */
-    double divisor = (mat->rows > 1) ? (mat->rows - 1) : 1;
-    for (int i = 0; i < cov->rows; i++) {
-        for (int j = 0; j < cov->cols; j++) {
-            cov->data[i][j] /= divisor;
+    free(owned);
+    return 0;
+}
+
+/* Copy the upper triangle of a square matrix into its lower triangle */
+static void symmetrize_upper(double *C, int n, int ldc) {
+    for (int i = 1; i < n; i++) {
+        for (int j = 0; j < i; j++) {
+            C[(size_t)i * ldc + j] = C[(size_t)j * ldc + i];
         }
     }
+}
+
+int matrix_gemm(const Matrix *A, const Matrix *B, Matrix *C) {
+    if (!A || !B || !C || A->cols != B->rows ||
+        C->rows != A->rows || C->cols != B->cols) {
+        print_error("Invalid GEMM dimensions");
+        return -1;
+    }
     
-    printf("  Covariance matrix: %d x %d\n", cov->rows, cov->cols);
+    if (gemm_driver(A->rows, B->cols, A->cols, A->values, A->stride, 0,
+                    B->values, B->stride, C->values, C->stride, 0, NULL) != 0) {
+        print_error("Failed to allocate GEMM packing buffers");
+        return -1;
+    }
+    return 0;
+}
+
+int matrix_syrk(const Matrix *X, Matrix *C) {
+    if (!X || !C || C->rows != X->cols || C->cols != X->cols) {
+        print_error("Invalid SYRK dimensions");
+        return -1;
+    }
     
-    return cov;
+    /* Upper triangle of X^T X, reading X in place as op(A) = X^T */
+    if (gemm_driver(X->cols, X->cols, X->rows, X->values, X->stride, 1,
+                    X->values, X->stride, C->values, C->stride, 1, NULL) != 0) {
+        print_error("Failed to allocate GEMM packing buffers");
+        return -1;
+    }
+    symmetrize_upper(C->values, C->rows, C->stride);
+    return 0;
 }
 
 /* ============================================
- * PCA Core Algorithm Implementation
+ * Dense Factorizations Implementation
  * ============================================ */
 
-int compute_eigen(const Matrix *cov_matrix, double *eigenvalues, 
-                 Matrix *eigenvectors, int max_iterations, double tolerance) {
-    if (!cov_matrix || !eigenvalues || !eigenvectors) return -1;
-    
-    print_progress("Computing eigenvalues and eigenvectors...");
-    
-    int n = cov_matrix->rows;
-    Matrix *A = matrix_create(n, n);
-    if (!A) return -1;
-    
-    /* Copy covariance matrix (we'll deflate it) */
-    matrix_copy(A, cov_matrix);
+/*
+ * Householder QR of a tall m x n row-major matrix (m >= n), in place:
+ * on exit the upper triangle holds R and the part below the diagonal
+ * holds the Householder vectors (unit leading entry implied), with the
+ * scalar factors in tau. Applying a reflector only needs w = v^T A and
+ * A -= tau v w^T, both of which stream whole rows; w holds n doubles.
+ */
+static int householder_qr(Matrix *A, double *tau, double *w) {
+    int m = A->rows;
+    int n = A->cols;
+    if (m < n) return -1;
     
-    /* Power iteration for each eigenvector */
-    for (int k = 0; k < n; k++) {
-        double *v = (double*)malloc(n * sizeof(double));
-        if (!v) {
-            matrix_free(A);
-            return -1;
+    for (int j = 0; j < n; j++) {
+        /* Build the reflector that zeroes A[j+1:, j] */
+        double alpha = MATRIX_ROW(A, j)[j];
+        double sigma = 0.0;
+        for (int i = j + 1; i < m; i++) {
+            double a = MATRIX_ROW(A, i)[j];
+            sigma += a * a;
         }
         
-        /* Initialize with random values */
-        for (int i = 0; i < n; i++) {
-            v[i] = 1.0 / sqrt(n);
+        if (sigma == 0.0) {
+            tau[j] = 0.0;
+            continue;
         }
         
-        /* Power iteration */
-        double lambda = 0.0;
-        for (int iter = 0; iter < max_iterations; iter++) {
-            /* v_new = A * v */
-            double *v_new = (double*)calloc(n, sizeof(double));
-            if (!v_new) {
-                free(v);
-                matrix_free(A);
-                return -1;
+        double norm = sqrt(alpha * alpha + sigma);
+        double beta = (alpha <= 0.0) ? norm : -norm;
+        double scale = 1.0 / (alpha - beta);
+        tau[j] = (beta - alpha) / beta;
+        for (int i = j + 1; i < m; i++) {
+            MATRIX_ROW(A, i)[j] *= scale;
+        }
+        MATRIX_ROW(A, j)[j] = beta;
+        
+        /* Apply it to the trailing columns: w = v^T A, A -= tau v w^T */
+        int rest = n - j - 1;
+        if (rest == 0) continue;
+        
+        memcpy(w, MATRIX_ROW(A, j) + j + 1, rest * sizeof(double));
+        for (int i = j + 1; i < m; i++) {
+            const double *row = MATRIX_ROW(A, i);
+            double v = row[j];
+            for (int c = 0; c < rest; c++) {
+                w[c] += v * row[j + 1 + c];
             }
-            
-            for (int i = 0; i < n; i++) {
-                for (int j = 0; j < n; j++) {
-                    v_new[i] += A->data[i][j] * v[j];
-                }
+        }
+        double *top = MATRIX_ROW(A, j) + j + 1;
+        for (int c = 0; c < rest; c++) {
+            top[c] -= tau[j] * w[c];
+        }
+        for (int i = j + 1; i < m; i++) {
+            double *row = MATRIX_ROW(A, i);
+            double tv = tau[j] * row[j];
+            for (int c = 0; c < rest; c++) {
+                row[j + 1 + c] -= tv * w[c];
             }
-            
+        }
+    }
+    
+    return 0;
+}
+
+/* Overwrite the output of householder_qr with the thin orthonormal
+ * factor Q (m x n), applying the reflectors backwards to [I; 0]. */
+static void householder_form_q(Matrix *A, const double *tau, double *w) {
+    int m = A->rows;
+    int n = A->cols;
+    
+    for (int j = n - 1; j >= 0; j--) {
+        /* Columns j+1.. already hold Q's trailing part; column j starts as e_j */
+        int rest = n - j - 1;
+        double t = tau[j];
+        
+        /* w = v^T Q[:, j+1:] (Q rows above j are zero in those columns) */
+        for (int c = 0; c < rest; c++) {
+            w[c] = 0.0;
+        }
+        for (int i = j + 1; i < m; i++) {
+            const double *row = MATRIX_ROW(A, i);
+            double v = row[j];
+            for (int c = 0; c < rest; c++) {
+                w[c] += v * row[j + 1 + c];
+            }
+        }
+        
+        /* Row j: v_j = 1 */
+        double *top = MATRIX_ROW(A, j);
+        for (int c = 0; c < rest; c++) {
+            top[j + 1 + c] = -t * w[c];
+        }
+        top[j] = 1.0 - t;
+        
+        for (int i = j + 1; i < m; i++) {
+            double *row = MATRIX_ROW(A, i);
+            double v = row[j];
+            for (int c = 0; c < rest; c++) {
+                row[j + 1 + c] -= t * v * w[c];
+            }
+            row[j] = -t * v;
+        }
+        
+        /* Rows above j in column j are zero */
+        for (int i = 0; i < j; i++) {
+            MATRIX_ROW(A, i)[j] = 0.0;
+        }
+    }
+}
+
+/* Replace a tall matrix with an orthonormal basis of its column space;
+ * tau and w each hold A->cols doubles */
+static int orthonormalize_columns(Matrix *A, double *tau, double *w) {
+    if (householder_qr(A, tau, w) != 0) return -1;
+    householder_form_q(A, tau, w);
+    return 0;
+}
+
+/* Maximum one-sided Jacobi sweeps */
+#define JACOBI_MAX_SWEEPS 60
+
+/*
+ * One-sided (Hestenes) Jacobi SVD acting on the rows of A (r x c): plane
+ * rotations are applied to pairs of rows until all rows are mutually
+ * orthogonal. Then A = J^T diag(sigma) U^T, where sigma[i] is the norm of
+ * row i and U^T's rows are the normalized rows (left in A). Row pairs are
+ * contiguous, and no Gram matrix is formed, so small singular values
+ * keep full relative accuracy. Returns the sweep count, or -1.
+ */
+static int jacobi_svd_rows(Matrix *A, double *sigma) {
+    int r = A->rows;
+    int c = A->cols;
+    const double eps = 2.220446049250313e-16;
+    int sweep;
+    
+    /* Rows at or below eps * ||A||_F are numerically zero (rank-deficient
+     * A): rotating them against each other only mixes rounding noise, so
+     * such pairs count as orthogonal. Rotations preserve ||A||_F. */
+    double frobenius = 0.0;
+    for (int i = 0; i < r; i++) {
+        frobenius += vector_dot(MATRIX_ROW(A, i), MATRIX_ROW(A, i), c);
+    }
+    double tiny = eps * eps * frobenius;
+    
+    for (sweep = 0; sweep < JACOBI_MAX_SWEEPS; sweep++) {
+        int rotated = 0;
+        
+        for (int p = 0; p < r - 1; p++) {
+            for (int q = p + 1; q < r; q++) {
+                double *ap = MATRIX_ROW(A, p);
+                double *aq = MATRIX_ROW(A, q);
+                double alpha = vector_dot(ap, ap, c);
+                double beta = vector_dot(aq, aq, c);
+                double gamma = vector_dot(ap, aq, c);
+                
+                if (alpha <= tiny || beta <= tiny) continue;
+                if (fabs(gamma) <= eps * sqrt(alpha * beta) || gamma == 0.0) continue;
+                rotated = 1;
+                
+                double zeta = (beta - alpha) / (2.0 * gamma);
+                double t = ((zeta >= 0.0) ? 1.0 : -1.0) /
+                           (fabs(zeta) + sqrt(1.0 + zeta * zeta));
+                double cs = 1.0 / sqrt(1.0 + t * t);
+                double sn = cs * t;
+                
+                for (int k = 0; k < c; k++) {
+                    double x = ap[k];
+                    double y = aq[k];
+                    ap[k] = cs * x - sn * y;
+                    aq[k] = sn * x + cs * y;
+                }
+            }
+        }
+        
+        if (!rotated) break;
+    }
+    
+    for (int i = 0; i < r; i++) {
+        double *row = MATRIX_ROW(A, i);
+        sigma[i] = vector_norm(row, c);
+        if (sigma[i] > 0.0) {
+            for (int k = 0; k < c; k++) {
+                row[k] /= sigma[i];
+            }
+        }
+    }
+    
+    return (sweep < JACOBI_MAX_SWEEPS) ? sweep : -1;
+}
+
+/* ============================================
+ * File I/O Operations Implementation
+ * ============================================ */
+
+/*
+ * Number parsing. Decimal text is split into a 19-digit integer mantissa
+ * and a power of ten; when both are small enough the value is one exact
+ * product or quotient of doubles (Clinger's fast path), which is already
+ * correctly rounded and covers fixed-precision CSV output. Longer
+ * mantissas, such as shortest round-trip output, take the Eisel-Lemire
+ * step (Lemire, "Number Parsing at a Gigabyte per Second"): the mantissa
+ * is multiplied by a 128-bit truncation of 5^q and the top bits give the
+ * correctly rounded double, which is exact for every 19-digit mantissa
+ * (Mushtak and Lemire, "Fast Number Parsing Without Fallback"). Only
+ * mantissas cut at 19 digits whose rounding depends on the dropped
+ * digits go to strtod pinned to the "C" locale, so the decimal point is
+ * '.' whatever locale the host program set.
+ */
+#define PARSE_MAX_DIGITS 19
+#define PARSE_MAX_EXACT_MANTISSA (1ULL << 53)
+#define PARSE_MIN_POW5 (-342)   /* Below: every 19-digit mantissa rounds to 0 */
+#define PARSE_MAX_POW5 308      /* Above: every mantissa overflows to infinity */
+
+/* 5^q for q = -342..308, normalized to 128 bits and truncated (high, low) */
+static const uint64_t parse_pow5_128[][2] = {
+    { 0xEEF453D6923BD65AULL, 0x113FAA2906A13B3FULL }, { 0x9558B4661B6565F8ULL, 0x4AC7CA59A424C507ULL },
+    { 0xBAAEE17FA23EBF76ULL, 0x5D79BCF00D2DF649ULL }, { 0xE95A99DF8ACE6F53ULL, 0xF4D82C2C107973DCULL },
+    { 0x91D8A02BB6C10594ULL, 0x79071B9B8A4BE869ULL }, { 0xB64EC836A47146F9ULL, 0x9748E2826CDEE284ULL },
+    { 0xE3E27A444D8D98B7ULL, 0xFD1B1B2308169B25ULL }, { 0x8E6D8C6AB0787F72ULL, 0xFE30F0F5E50E20F7ULL },
+    { 0xB208EF855C969F4FULL, 0xBDBD2D335E51A935ULL }, { 0xDE8B2B66B3BC4723ULL, 0xAD2C788035E61382ULL },
+    { 0x8B16FB203055AC76ULL, 0x4C3BCB5021AFCC31ULL }, { 0xADDCB9E83C6B1793ULL, 0xDF4ABE242A1BBF3DULL },
+    { 0xD953E8624B85DD78ULL, 0xD71D6DAD34A2AF0DULL }, { 0x87D4713D6F33AA6BULL, 0x8672648C40E5AD68ULL },
+    { 0xA9C98D8CCB009506ULL, 0x680EFDAF511F18C2ULL }, { 0xD43BF0EFFDC0BA48ULL, 0x0212BD1B2566DEF2ULL },
+    { 0x84A57695FE98746DULL, 0x014BB630F7604B57ULL }, { 0xA5CED43B7E3E9188ULL, 0x419EA3BD35385E2DULL },
+    { 0xCF42894A5DCE35EAULL, 0x52064CAC828675B9ULL }, { 0x818995CE7AA0E1B2ULL, 0x7343EFEBD1940993ULL },
+    { 0xA1EBFB4219491A1FULL, 0x1014EBE6C5F90BF8ULL }, { 0xCA66FA129F9B60A6ULL, 0xD41A26E077774EF6ULL },
+    { 0xFD00B897478238D0ULL, 0x8920B098955522B4ULL }, { 0x9E20735E8CB16382ULL, 0x55B46E5F5D5535B0ULL },
+    { 0xC5A890362FDDBC62ULL, 0xEB2189F734AA831DULL }, { 0xF712B443BBD52B7BULL, 0xA5E9EC7501D523E4ULL },
+    { 0x9A6BB0AA55653B2DULL, 0x47B233C92125366EULL }, { 0xC1069CD4EABE89F8ULL, 0x999EC0BB696E840AULL },
+    { 0xF148440A256E2C76ULL, 0xC00670EA43CA250DULL }, { 0x96CD2A865764DBCAULL, 0x380406926A5E5728ULL },
+    { 0xBC807527ED3E12BCULL, 0xC605083704F5ECF2ULL }, { 0xEBA09271E88D976BULL, 0xF7864A44C633682EULL },
+    { 0x93445B8731587EA3ULL, 0x7AB3EE6AFBE0211DULL }, { 0xB8157268FDAE9E4CULL, 0x5960EA05BAD82964ULL },
+    { 0xE61ACF033D1A45DFULL, 0x6FB92487298E33BDULL }, { 0x8FD0C16206306BABULL, 0xA5D3B6D479F8E056ULL },
+    { 0xB3C4F1BA87BC8696ULL, 0x8F48A4899877186CULL }, { 0xE0B62E2929ABA83CULL, 0x331ACDABFE94DE87ULL },
+    { 0x8C71DCD9BA0B4925ULL, 0x9FF0C08B7F1D0B14ULL }, { 0xAF8E5410288E1B6FULL, 0x07ECF0AE5EE44DD9ULL },
+    { 0xDB71E91432B1A24AULL, 0xC9E82CD9F69D6150ULL }, { 0x892731AC9FAF056EULL, 0xBE311C083A225CD2ULL },
+    { 0xAB70FE17C79AC6CAULL, 0x6DBD630A48AAF406ULL }, { 0xD64D3D9DB981787DULL, 0x092CBBCCDAD5B108ULL },
+    { 0x85F0468293F0EB4EULL, 0x25BBF56008C58EA5ULL }, { 0xA76C582338ED2621ULL, 0xAF2AF2B80AF6F24EULL },
+    { 0xD1476E2C07286FAAULL, 0x1AF5AF660DB4AEE1ULL }, { 0x82CCA4DB847945CAULL, 0x50D98D9FC890ED4DULL },
+    { 0xA37FCE126597973CULL, 0xE50FF107BAB528A0ULL }, { 0xCC5FC196FEFD7D0CULL, 0x1E53ED49A96272C8ULL },
+    { 0xFF77B1FCBEBCDC4FULL, 0x25E8E89C13BB0F7AULL }, { 0x9FAACF3DF73609B1ULL, 0x77B191618C54E9ACULL },
+    { 0xC795830D75038C1DULL, 0xD59DF5B9EF6A2417ULL }, { 0xF97AE3D0D2446F25ULL, 0x4B0573286B44AD1DULL },
+    { 0x9BECCE62836AC577ULL, 0x4EE367F9430AEC32ULL }, { 0xC2E801FB244576D5ULL, 0x229C41F793CDA73FULL },
+    { 0xF3A20279ED56D48AULL, 0x6B43527578C1110FULL }, { 0x9845418C345644D6ULL, 0x830A13896B78AAA9ULL },
+    { 0xBE5691EF416BD60CULL, 0x23CC986BC656D553ULL }, { 0xEDEC366B11C6CB8FULL, 0x2CBFBE86B7EC8AA8ULL },
+    { 0x94B3A202EB1C3F39ULL, 0x7BF7D71432F3D6A9ULL }, { 0xB9E08A83A5E34F07ULL, 0xDAF5CCD93FB0CC53ULL },
+    { 0xE858AD248F5C22C9ULL, 0xD1B3400F8F9CFF68ULL }, { 0x91376C36D99995BEULL, 0x23100809B9C21FA1ULL },
+    { 0xB58547448FFFFB2DULL, 0xABD40A0C2832A78AULL }, { 0xE2E69915B3FFF9F9ULL, 0x16C90C8F323F516CULL },
+    { 0x8DD01FAD907FFC3BULL, 0xAE3DA7D97F6792E3ULL }, { 0xB1442798F49FFB4AULL, 0x99CD11CFDF41779CULL },
+    { 0xDD95317F31C7FA1DULL, 0x40405643D711D583ULL }, { 0x8A7D3EEF7F1CFC52ULL, 0x482835EA666B2572ULL },
+    { 0xAD1C8EAB5EE43B66ULL, 0xDA3243650005EECFULL }, { 0xD863B256369D4A40ULL, 0x90BED43E40076A82ULL },
+    { 0x873E4F75E2224E68ULL, 0x5A7744A6E804A291ULL }, { 0xA90DE3535AAAE202ULL, 0x711515D0A205CB36ULL },
+    { 0xD3515C2831559A83ULL, 0x0D5A5B44CA873E03ULL }, { 0x8412D9991ED58091ULL, 0xE858790AFE9486C2ULL },
+    { 0xA5178FFF668AE0B6ULL, 0x626E974DBE39A872ULL }, { 0xCE5D73FF402D98E3ULL, 0xFB0A3D212DC8128FULL },
+    { 0x80FA687F881C7F8EULL, 0x7CE66634BC9D0B99ULL }, { 0xA139029F6A239F72ULL, 0x1C1FFFC1EBC44E80ULL },
+    { 0xC987434744AC874EULL, 0xA327FFB266B56220ULL }, { 0xFBE9141915D7A922ULL, 0x4BF1FF9F0062BAA8ULL },
+    { 0x9D71AC8FADA6C9B5ULL, 0x6F773FC3603DB4A9ULL }, { 0xC4CE17B399107C22ULL, 0xCB550FB4384D21D3ULL },
+    { 0xF6019DA07F549B2BULL, 0x7E2A53A146606A48ULL }, { 0x99C102844F94E0FBULL, 0x2EDA7444CBFC426DULL },
+    { 0xC0314325637A1939ULL, 0xFA911155FEFB5308ULL }, { 0xF03D93EEBC589F88ULL, 0x793555AB7EBA27CAULL },
+    { 0x96267C7535B763B5ULL, 0x4BC1558B2F3458DEULL }, { 0xBBB01B9283253CA2ULL, 0x9EB1AAEDFB016F16ULL },
+    { 0xEA9C227723EE8BCBULL, 0x465E15A979C1CADCULL }, { 0x92A1958A7675175FULL, 0x0BFACD89EC191EC9ULL },
+    { 0xB749FAED14125D36ULL, 0xCEF980EC671F667BULL }, { 0xE51C79A85916F484ULL, 0x82B7E12780E7401AULL },
+    { 0x8F31CC0937AE58D2ULL, 0xD1B2ECB8B0908810ULL }, { 0xB2FE3F0B8599EF07ULL, 0x861FA7E6DCB4AA15ULL },
+    { 0xDFBDCECE67006AC9ULL, 0x67A791E093E1D49AULL }, { 0x8BD6A141006042BDULL, 0xE0C8BB2C5C6D24E0ULL },
+    { 0xAECC49914078536DULL, 0x58FAE9F773886E18ULL }, { 0xDA7F5BF590966848ULL, 0xAF39A475506A899EULL },
+    { 0x888F99797A5E012DULL, 0x6D8406C952429603ULL }, { 0xAAB37FD7D8F58178ULL, 0xC8E5087BA6D33B83ULL },
+    { 0xD5605FCDCF32E1D6ULL, 0xFB1E4A9A90880A64ULL }, { 0x855C3BE0A17FCD26ULL, 0x5CF2EEA09A55067FULL },
+    { 0xA6B34AD8C9DFC06FULL, 0xF42FAA48C0EA481EULL }, { 0xD0601D8EFC57B08BULL, 0xF13B94DAF124DA26ULL },
+    { 0x823C12795DB6CE57ULL, 0x76C53D08D6B70858ULL }, { 0xA2CB1717B52481EDULL, 0x54768C4B0C64CA6EULL },
+    { 0xCB7DDCDDA26DA268ULL, 0xA9942F5DCF7DFD09ULL }, { 0xFE5D54150B090B02ULL, 0xD3F93B35435D7C4CULL },
+    { 0x9EFA548D26E5A6E1ULL, 0xC47BC5014A1A6DAFULL }, { 0xC6B8E9B0709F109AULL, 0x359AB6419CA1091BULL },
+    { 0xF867241C8CC6D4C0ULL, 0xC30163D203C94B62ULL }, { 0x9B407691D7FC44F8ULL, 0x79E0DE63425DCF1DULL },
+    { 0xC21094364DFB5636ULL, 0x985915FC12F542E4ULL }, { 0xF294B943E17A2BC4ULL, 0x3E6F5B7B17B2939DULL },
+    { 0x979CF3CA6CEC5B5AULL, 0xA705992CEECF9C42ULL }, { 0xBD8430BD08277231ULL, 0x50C6FF782A838353ULL },
+    { 0xECE53CEC4A314EBDULL, 0xA4F8BF5635246428ULL }, { 0x940F4613AE5ED136ULL, 0x871B7795E136BE99ULL },
+    { 0xB913179899F68584ULL, 0x28E2557B59846E3FULL }, { 0xE757DD7EC07426E5ULL, 0x331AEADA2FE589CFULL },
+    { 0x9096EA6F3848984FULL, 0x3FF0D2C85DEF7621ULL }, { 0xB4BCA50B065ABE63ULL, 0x0FED077A756B53A9ULL },
+    { 0xE1EBCE4DC7F16DFBULL, 0xD3E8495912C62894ULL }, { 0x8D3360F09CF6E4BDULL, 0x64712DD7ABBBD95CULL },
+    { 0xB080392CC4349DECULL, 0xBD8D794D96AACFB3ULL }, { 0xDCA04777F541C567ULL, 0xECF0D7A0FC5583A0ULL },
+    { 0x89E42CAAF9491B60ULL, 0xF41686C49DB57244ULL }, { 0xAC5D37D5B79B6239ULL, 0x311C2875C522CED5ULL },
+    { 0xD77485CB25823AC7ULL, 0x7D633293366B828BULL }, { 0x86A8D39EF77164BCULL, 0xAE5DFF9C02033197ULL },
+    { 0xA8530886B54DBDEBULL, 0xD9F57F830283FDFCULL }, { 0xD267CAA862A12D66ULL, 0xD072DF63C324FD7BULL },
+    { 0x8380DEA93DA4BC60ULL, 0x4247CB9E59F71E6DULL }, { 0xA46116538D0DEB78ULL, 0x52D9BE85F074E608ULL },
+    { 0xCD795BE870516656ULL, 0x67902E276C921F8BULL }, { 0x806BD9714632DFF6ULL, 0x00BA1CD8A3DB53B6ULL },
+    { 0xA086CFCD97BF97F3ULL, 0x80E8A40ECCD228A4ULL }, { 0xC8A883C0FDAF7DF0ULL, 0x6122CD128006B2CDULL },
+    { 0xFAD2A4B13D1B5D6CULL, 0x796B805720085F81ULL }, { 0x9CC3A6EEC6311A63ULL, 0xCBE3303674053BB0ULL },
+    { 0xC3F490AA77BD60FCULL, 0xBEDBFC4411068A9CULL }, { 0xF4F1B4D515ACB93BULL, 0xEE92FB5515482D44ULL },
+    { 0x991711052D8BF3C5ULL, 0x751BDD152D4D1C4AULL }, { 0xBF5CD54678EEF0B6ULL, 0xD262D45A78A0635DULL },
+    { 0xEF340A98172AACE4ULL, 0x86FB897116C87C34ULL }, { 0x9580869F0E7AAC0EULL, 0xD45D35E6AE3D4DA0ULL },
+    { 0xBAE0A846D2195712ULL, 0x8974836059CCA109ULL }, { 0xE998D258869FACD7ULL, 0x2BD1A438703FC94BULL },
+    { 0x91FF83775423CC06ULL, 0x7B6306A34627DDCFULL }, { 0xB67F6455292CBF08ULL, 0x1A3BC84C17B1D542ULL },
+    { 0xE41F3D6A7377EECAULL, 0x20CABA5F1D9E4A93ULL }, { 0x8E938662882AF53EULL, 0x547EB47B7282EE9CULL },
+    { 0xB23867FB2A35B28DULL, 0xE99E619A4F23AA43ULL }, { 0xDEC681F9F4C31F31ULL, 0x6405FA00E2EC94D4ULL },
+    { 0x8B3C113C38F9F37EULL, 0xDE83BC408DD3DD04ULL }, { 0xAE0B158B4738705EULL, 0x9624AB50B148D445ULL },
+    { 0xD98DDAEE19068C76ULL, 0x3BADD624DD9B0957ULL }, { 0x87F8A8D4CFA417C9ULL, 0xE54CA5D70A80E5D6ULL },
+    { 0xA9F6D30A038D1DBCULL, 0x5E9FCF4CCD211F4CULL }, { 0xD47487CC8470652BULL, 0x7647C3200069671FULL },
+    { 0x84C8D4DFD2C63F3BULL, 0x29ECD9F40041E073ULL }, { 0xA5FB0A17C777CF09ULL, 0xF468107100525890ULL },
+    { 0xCF79CC9DB955C2CCULL, 0x7182148D4066EEB4ULL }, { 0x81AC1FE293D599BFULL, 0xC6F14CD848405530ULL },
+    { 0xA21727DB38CB002FULL, 0xB8ADA00E5A506A7CULL }, { 0xCA9CF1D206FDC03BULL, 0xA6D90811F0E4851CULL },
+    { 0xFD442E4688BD304AULL, 0x908F4A166D1DA663ULL }, { 0x9E4A9CEC15763E2EULL, 0x9A598E4E043287FEULL },
+    { 0xC5DD44271AD3CDBAULL, 0x40EFF1E1853F29FDULL }, { 0xF7549530E188C128ULL, 0xD12BEE59E68EF47CULL },
+    { 0x9A94DD3E8CF578B9ULL, 0x82BB74F8301958CEULL }, { 0xC13A148E3032D6E7ULL, 0xE36A52363C1FAF01ULL },
+    { 0xF18899B1BC3F8CA1ULL, 0xDC44E6C3CB279AC1ULL }, { 0x96F5600F15A7B7E5ULL, 0x29AB103A5EF8C0B9ULL },
+    { 0xBCB2B812DB11A5DEULL, 0x7415D448F6B6F0E7ULL }, { 0xEBDF661791D60F56ULL, 0x111B495B3464AD21ULL },
+    { 0x936B9FCEBB25C995ULL, 0xCAB10DD900BEEC34ULL }, { 0xB84687C269EF3BFBULL, 0x3D5D514F40EEA742ULL },
+    { 0xE65829B3046B0AFAULL, 0x0CB4A5A3112A5112ULL }, { 0x8FF71A0FE2C2E6DCULL, 0x47F0E785EABA72ABULL },
+    { 0xB3F4E093DB73A093ULL, 0x59ED216765690F56ULL }, { 0xE0F218B8D25088B8ULL, 0x306869C13EC3532CULL },
+    { 0x8C974F7383725573ULL, 0x1E414218C73A13FBULL }, { 0xAFBD2350644EEACFULL, 0xE5D1929EF90898FAULL },
+    { 0xDBAC6C247D62A583ULL, 0xDF45F746B74ABF39ULL }, { 0x894BC396CE5DA772ULL, 0x6B8BBA8C328EB783ULL },
+    { 0xAB9EB47C81F5114FULL, 0x066EA92F3F326564ULL }, { 0xD686619BA27255A2ULL, 0xC80A537B0EFEFEBDULL },
+    { 0x8613FD0145877585ULL, 0xBD06742CE95F5F36ULL }, { 0xA798FC4196E952E7ULL, 0x2C48113823B73704ULL },
+    { 0xD17F3B51FCA3A7A0ULL, 0xF75A15862CA504C5ULL }, { 0x82EF85133DE648C4ULL, 0x9A984D73DBE722FBULL },
+    { 0xA3AB66580D5FDAF5ULL, 0xC13E60D0D2E0EBBAULL }, { 0xCC963FEE10B7D1B3ULL, 0x318DF905079926A8ULL },
+    { 0xFFBBCFE994E5C61FULL, 0xFDF17746497F7052ULL }, { 0x9FD561F1FD0F9BD3ULL, 0xFEB6EA8BEDEFA633ULL },
+    { 0xC7CABA6E7C5382C8ULL, 0xFE64A52EE96B8FC0ULL }, { 0xF9BD690A1B68637BULL, 0x3DFDCE7AA3C673B0ULL },
+    { 0x9C1661A651213E2DULL, 0x06BEA10CA65C084EULL }, { 0xC31BFA0FE5698DB8ULL, 0x486E494FCFF30A62ULL },
+    { 0xF3E2F893DEC3F126ULL, 0x5A89DBA3C3EFCCFAULL }, { 0x986DDB5C6B3A76B7ULL, 0xF89629465A75E01CULL },
+    { 0xBE89523386091465ULL, 0xF6BBB397F1135823ULL }, { 0xEE2BA6C0678B597FULL, 0x746AA07DED582E2CULL },
+    { 0x94DB483840B717EFULL, 0xA8C2A44EB4571CDCULL }, { 0xBA121A4650E4DDEBULL, 0x92F34D62616CE413ULL },
+    { 0xE896A0D7E51E1566ULL, 0x77B020BAF9C81D17ULL }, { 0x915E2486EF32CD60ULL, 0x0ACE1474DC1D122EULL },
+    { 0xB5B5ADA8AAFF80B8ULL, 0x0D819992132456BAULL }, { 0xE3231912D5BF60E6ULL, 0x10E1FFF697ED6C69ULL },
+    { 0x8DF5EFABC5979C8FULL, 0xCA8D3FFA1EF463C1ULL }, { 0xB1736B96B6FD83B3ULL, 0xBD308FF8A6B17CB2ULL },
+    { 0xDDD0467C64BCE4A0ULL, 0xAC7CB3F6D05DDBDEULL }, { 0x8AA22C0DBEF60EE4ULL, 0x6BCDF07A423AA96BULL },
+    { 0xAD4AB7112EB3929DULL, 0x86C16C98D2C953C6ULL }, { 0xD89D64D57A607744ULL, 0xE871C7BF077BA8B7ULL },
+    { 0x87625F056C7C4A8BULL, 0x11471CD764AD4972ULL }, { 0xA93AF6C6C79B5D2DULL, 0xD598E40D3DD89BCFULL },
+    { 0xD389B47879823479ULL, 0x4AFF1D108D4EC2C3ULL }, { 0x843610CB4BF160CBULL, 0xCEDF722A585139BAULL },
+    { 0xA54394FE1EEDB8FEULL, 0xC2974EB4EE658828ULL }, { 0xCE947A3DA6A9273EULL, 0x733D226229FEEA32ULL },
+    { 0x811CCC668829B887ULL, 0x0806357D5A3F525FULL }, { 0xA163FF802A3426A8ULL, 0xCA07C2DCB0CF26F7ULL },
+    { 0xC9BCFF6034C13052ULL, 0xFC89B393DD02F0B5ULL }, { 0xFC2C3F3841F17C67ULL, 0xBBAC2078D443ACE2ULL },
+    { 0x9D9BA7832936EDC0ULL, 0xD54B944B84AA4C0DULL }, { 0xC5029163F384A931ULL, 0x0A9E795E65D4DF11ULL },
+    { 0xF64335BCF065D37DULL, 0x4D4617B5FF4A16D5ULL }, { 0x99EA0196163FA42EULL, 0x504BCED1BF8E4E45ULL },
+    { 0xC06481FB9BCF8D39ULL, 0xE45EC2862F71E1D6ULL }, { 0xF07DA27A82C37088ULL, 0x5D767327BB4E5A4CULL },
+    { 0x964E858C91BA2655ULL, 0x3A6A07F8D510F86FULL }, { 0xBBE226EFB628AFEAULL, 0x890489F70A55368BULL },
+    { 0xEADAB0ABA3B2DBE5ULL, 0x2B45AC74CCEA842EULL }, { 0x92C8AE6B464FC96FULL, 0x3B0B8BC90012929DULL },
+    { 0xB77ADA0617E3BBCBULL, 0x09CE6EBB40173744ULL }, { 0xE55990879DDCAABDULL, 0xCC420A6A101D0515ULL },
+    { 0x8F57FA54C2A9EAB6ULL, 0x9FA946824A12232DULL }, { 0xB32DF8E9F3546564ULL, 0x47939822DC96ABF9ULL },
+    { 0xDFF9772470297EBDULL, 0x59787E2B93BC56F7ULL }, { 0x8BFBEA76C619EF36ULL, 0x57EB4EDB3C55B65AULL },
+    { 0xAEFAE51477A06B03ULL, 0xEDE622920B6B23F1ULL }, { 0xDAB99E59958885C4ULL, 0xE95FAB368E45ECEDULL },
+    { 0x88B402F7FD75539BULL, 0x11DBCB0218EBB414ULL }, { 0xAAE103B5FCD2A881ULL, 0xD652BDC29F26A119ULL },
+    { 0xD59944A37C0752A2ULL, 0x4BE76D3346F0495FULL }, { 0x857FCAE62D8493A5ULL, 0x6F70A4400C562DDBULL },
+    { 0xA6DFBD9FB8E5B88EULL, 0xCB4CCD500F6BB952ULL }, { 0xD097AD07A71F26B2ULL, 0x7E2000A41346A7A7ULL },
+    { 0x825ECC24C873782FULL, 0x8ED400668C0C28C8ULL }, { 0xA2F67F2DFA90563BULL, 0x728900802F0F32FAULL },
+    { 0xCBB41EF979346BCAULL, 0x4F2B40A03AD2FFB9ULL }, { 0xFEA126B7D78186BCULL, 0xE2F610C84987BFA8ULL },
+    { 0x9F24B832E6B0F436ULL, 0x0DD9CA7D2DF4D7C9ULL }, { 0xC6EDE63FA05D3143ULL, 0x91503D1C79720DBBULL },
+    { 0xF8A95FCF88747D94ULL, 0x75A44C6397CE912AULL }, { 0x9B69DBE1B548CE7CULL, 0xC986AFBE3EE11ABAULL },
+    { 0xC24452DA229B021BULL, 0xFBE85BADCE996168ULL }, { 0xF2D56790AB41C2A2ULL, 0xFAE27299423FB9C3ULL },
+    { 0x97C560BA6B0919A5ULL, 0xDCCD879FC967D41AULL }, { 0xBDB6B8E905CB600FULL, 0x5400E987BBC1C920ULL },
+    { 0xED246723473E3813ULL, 0x290123E9AAB23B68ULL }, { 0x9436C0760C86E30BULL, 0xF9A0B6720AAF6521ULL },
+    { 0xB94470938FA89BCEULL, 0xF808E40E8D5B3E69ULL }, { 0xE7958CB87392C2C2ULL, 0xB60B1D1230B20E04ULL },
+    { 0x90BD77F3483BB9B9ULL, 0xB1C6F22B5E6F48C2ULL }, { 0xB4ECD5F01A4AA828ULL, 0x1E38AEB6360B1AF3ULL },
+    { 0xE2280B6C20DD5232ULL, 0x25C6DA63C38DE1B0ULL }, { 0x8D590723948A535FULL, 0x579C487E5A38AD0EULL },
+    { 0xB0AF48EC79ACE837ULL, 0x2D835A9DF0C6D851ULL }, { 0xDCDB1B2798182244ULL, 0xF8E431456CF88E65ULL },
+    { 0x8A08F0F8BF0F156BULL, 0x1B8E9ECB641B58FFULL }, { 0xAC8B2D36EED2DAC5ULL, 0xE272467E3D222F3FULL },
+    { 0xD7ADF884AA879177ULL, 0x5B0ED81DCC6ABB0FULL }, { 0x86CCBB52EA94BAEAULL, 0x98E947129FC2B4E9ULL },
+    { 0xA87FEA27A539E9A5ULL, 0x3F2398D747B36224ULL }, { 0xD29FE4B18E88640EULL, 0x8EEC7F0D19A03AADULL },
+    { 0x83A3EEEEF9153E89ULL, 0x1953CF68300424ACULL }, { 0xA48CEAAAB75A8E2BULL, 0x5FA8C3423C052DD7ULL },
+    { 0xCDB02555653131B6ULL, 0x3792F412CB06794DULL }, { 0x808E17555F3EBF11ULL, 0xE2BBD88BBEE40BD0ULL },
+    { 0xA0B19D2AB70E6ED6ULL, 0x5B6ACEAEAE9D0EC4ULL }, { 0xC8DE047564D20A8BULL, 0xF245825A5A445275ULL },
+    { 0xFB158592BE068D2EULL, 0xEED6E2F0F0D56712ULL }, { 0x9CED737BB6C4183DULL, 0x55464DD69685606BULL },
+    { 0xC428D05AA4751E4CULL, 0xAA97E14C3C26B886ULL }, { 0xF53304714D9265DFULL, 0xD53DD99F4B3066A8ULL },
+    { 0x993FE2C6D07B7FABULL, 0xE546A8038EFE4029ULL }, { 0xBF8FDB78849A5F96ULL, 0xDE98520472BDD033ULL },
+    { 0xEF73D256A5C0F77CULL, 0x963E66858F6D4440ULL }, { 0x95A8637627989AADULL, 0xDDE7001379A44AA8ULL },
+    { 0xBB127C53B17EC159ULL, 0x5560C018580D5D52ULL }, { 0xE9D71B689DDE71AFULL, 0xAAB8F01E6E10B4A6ULL },
+    { 0x9226712162AB070DULL, 0xCAB3961304CA70E8ULL }, { 0xB6B00D69BB55C8D1ULL, 0x3D607B97C5FD0D22ULL },
+    { 0xE45C10C42A2B3B05ULL, 0x8CB89A7DB77C506AULL }, { 0x8EB98A7A9A5B04E3ULL, 0x77F3608E92ADB242ULL },
+    { 0xB267ED1940F1C61CULL, 0x55F038B237591ED3ULL }, { 0xDF01E85F912E37A3ULL, 0x6B6C46DEC52F6688ULL },
+    { 0x8B61313BBABCE2C6ULL, 0x2323AC4B3B3DA015ULL }, { 0xAE397D8AA96C1B77ULL, 0xABEC975E0A0D081AULL },
+    { 0xD9C7DCED53C72255ULL, 0x96E7BD358C904A21ULL }, { 0x881CEA14545C7575ULL, 0x7E50D64177DA2E54ULL },
+    { 0xAA242499697392D2ULL, 0xDDE50BD1D5D0B9E9ULL }, { 0xD4AD2DBFC3D07787ULL, 0x955E4EC64B44E864ULL },
+    { 0x84EC3C97DA624AB4ULL, 0xBD5AF13BEF0B113EULL }, { 0xA6274BBDD0FADD61ULL, 0xECB1AD8AEACDD58EULL },
+    { 0xCFB11EAD453994BAULL, 0x67DE18EDA5814AF2ULL }, { 0x81CEB32C4B43FCF4ULL, 0x80EACF948770CED7ULL },
+    { 0xA2425FF75E14FC31ULL, 0xA1258379A94D028DULL }, { 0xCAD2F7F5359A3B3EULL, 0x096EE45813A04330ULL },
+    { 0xFD87B5F28300CA0DULL, 0x8BCA9D6E188853FCULL }, { 0x9E74D1B791E07E48ULL, 0x775EA264CF55347EULL },
+    { 0xC612062576589DDAULL, 0x95364AFE032A819EULL }, { 0xF79687AED3EEC551ULL, 0x3A83DDBD83F52205ULL },
+    { 0x9ABE14CD44753B52ULL, 0xC4926A9672793543ULL }, { 0xC16D9A0095928A27ULL, 0x75B7053C0F178294ULL },
+    { 0xF1C90080BAF72CB1ULL, 0x5324C68B12DD6339ULL }, { 0x971DA05074DA7BEEULL, 0xD3F6FC16EBCA5E04ULL },
+    { 0xBCE5086492111AEAULL, 0x88F4BB1CA6BCF585ULL }, { 0xEC1E4A7DB69561A5ULL, 0x2B31E9E3D06C32E6ULL },
+    { 0x9392EE8E921D5D07ULL, 0x3AFF322E62439FD0ULL }, { 0xB877AA3236A4B449ULL, 0x09BEFEB9FAD487C3ULL },
+    { 0xE69594BEC44DE15BULL, 0x4C2EBE687989A9B4ULL }, { 0x901D7CF73AB0ACD9ULL, 0x0F9D37014BF60A11ULL },
+    { 0xB424DC35095CD80FULL, 0x538484C19EF38C95ULL }, { 0xE12E13424BB40E13ULL, 0x2865A5F206B06FBAULL },
+    { 0x8CBCCC096F5088CBULL, 0xF93F87B7442E45D4ULL }, { 0xAFEBFF0BCB24AAFEULL, 0xF78F69A51539D749ULL },
+    { 0xDBE6FECEBDEDD5BEULL, 0xB573440E5A884D1CULL }, { 0x89705F4136B4A597ULL, 0x31680A88F8953031ULL },
+    { 0xABCC77118461CEFCULL, 0xFDC20D2B36BA7C3EULL }, { 0xD6BF94D5E57A42BCULL, 0x3D32907604691B4DULL },
+    { 0x8637BD05AF6C69B5ULL, 0xA63F9A49C2C1B110ULL }, { 0xA7C5AC471B478423ULL, 0x0FCF80DC33721D54ULL },
+    { 0xD1B71758E219652BULL, 0xD3C36113404EA4A9ULL }, { 0x83126E978D4FDF3BULL, 0x645A1CAC083126EAULL },
+    { 0xA3D70A3D70A3D70AULL, 0x3D70A3D70A3D70A4ULL }, { 0xCCCCCCCCCCCCCCCCULL, 0xCCCCCCCCCCCCCCCDULL },
+    { 0x8000000000000000ULL, 0x0000000000000000ULL }, { 0xA000000000000000ULL, 0x0000000000000000ULL },
+    { 0xC800000000000000ULL, 0x0000000000000000ULL }, { 0xFA00000000000000ULL, 0x0000000000000000ULL },
+    { 0x9C40000000000000ULL, 0x0000000000000000ULL }, { 0xC350000000000000ULL, 0x0000000000000000ULL },
+    { 0xF424000000000000ULL, 0x0000000000000000ULL }, { 0x9896800000000000ULL, 0x0000000000000000ULL },
+    { 0xBEBC200000000000ULL, 0x0000000000000000ULL }, { 0xEE6B280000000000ULL, 0x0000000000000000ULL },
+    { 0x9502F90000000000ULL, 0x0000000000000000ULL }, { 0xBA43B74000000000ULL, 0x0000000000000000ULL },
+    { 0xE8D4A51000000000ULL, 0x0000000000000000ULL }, { 0x9184E72A00000000ULL, 0x0000000000000000ULL },
+    { 0xB5E620F480000000ULL, 0x0000000000000000ULL }, { 0xE35FA931A0000000ULL, 0x0000000000000000ULL },
+    { 0x8E1BC9BF04000000ULL, 0x0000000000000000ULL }, { 0xB1A2BC2EC5000000ULL, 0x0000000000000000ULL },
+    { 0xDE0B6B3A76400000ULL, 0x0000000000000000ULL }, { 0x8AC7230489E80000ULL, 0x0000000000000000ULL },
+    { 0xAD78EBC5AC620000ULL, 0x0000000000000000ULL }, { 0xD8D726B7177A8000ULL, 0x0000000000000000ULL },
+    { 0x878678326EAC9000ULL, 0x0000000000000000ULL }, { 0xA968163F0A57B400ULL, 0x0000000000000000ULL },
+    { 0xD3C21BCECCEDA100ULL, 0x0000000000000000ULL }, { 0x84595161401484A0ULL, 0x0000000000000000ULL },
+    { 0xA56FA5B99019A5C8ULL, 0x0000000000000000ULL }, { 0xCECB8F27F4200F3AULL, 0x0000000000000000ULL },
+    { 0x813F3978F8940984ULL, 0x4000000000000000ULL }, { 0xA18F07D736B90BE5ULL, 0x5000000000000000ULL },
+    { 0xC9F2C9CD04674EDEULL, 0xA400000000000000ULL }, { 0xFC6F7C4045812296ULL, 0x4D00000000000000ULL },
+    { 0x9DC5ADA82B70B59DULL, 0xF020000000000000ULL }, { 0xC5371912364CE305ULL, 0x6C28000000000000ULL },
+    { 0xF684DF56C3E01BC6ULL, 0xC732000000000000ULL }, { 0x9A130B963A6C115CULL, 0x3C7F400000000000ULL },
+    { 0xC097CE7BC90715B3ULL, 0x4B9F100000000000ULL }, { 0xF0BDC21ABB48DB20ULL, 0x1E86D40000000000ULL },
+    { 0x96769950B50D88F4ULL, 0x1314448000000000ULL }, { 0xBC143FA4E250EB31ULL, 0x17D955A000000000ULL },
+    { 0xEB194F8E1AE525FDULL, 0x5DCFAB0800000000ULL }, { 0x92EFD1B8D0CF37BEULL, 0x5AA1CAE500000000ULL },
+    { 0xB7ABC627050305ADULL, 0xF14A3D9E40000000ULL }, { 0xE596B7B0C643C719ULL, 0x6D9CCD05D0000000ULL },
+    { 0x8F7E32CE7BEA5C6FULL, 0xE4820023A2000000ULL }, { 0xB35DBF821AE4F38BULL, 0xDDA2802C8A800000ULL },
+    { 0xE0352F62A19E306EULL, 0xD50B2037AD200000ULL }, { 0x8C213D9DA502DE45ULL, 0x4526F422CC340000ULL },
+    { 0xAF298D050E4395D6ULL, 0x9670B12B7F410000ULL }, { 0xDAF3F04651D47B4CULL, 0x3C0CDD765F114000ULL },
+    { 0x88D8762BF324CD0FULL, 0xA5880A69FB6AC800ULL }, { 0xAB0E93B6EFEE0053ULL, 0x8EEA0D047A457A00ULL },
+    { 0xD5D238A4ABE98068ULL, 0x72A4904598D6D880ULL }, { 0x85A36366EB71F041ULL, 0x47A6DA2B7F864750ULL },
+    { 0xA70C3C40A64E6C51ULL, 0x999090B65F67D924ULL }, { 0xD0CF4B50CFE20765ULL, 0xFFF4B4E3F741CF6DULL },
+    { 0x82818F1281ED449FULL, 0xBFF8F10E7A8921A4ULL }, { 0xA321F2D7226895C7ULL, 0xAFF72D52192B6A0DULL },
+    { 0xCBEA6F8CEB02BB39ULL, 0x9BF4F8A69F764490ULL }, { 0xFEE50B7025C36A08ULL, 0x02F236D04753D5B4ULL },
+    { 0x9F4F2726179A2245ULL, 0x01D762422C946590ULL }, { 0xC722F0EF9D80AAD6ULL, 0x424D3AD2B7B97EF5ULL },
+    { 0xF8EBAD2B84E0D58BULL, 0xD2E0898765A7DEB2ULL }, { 0x9B934C3B330C8577ULL, 0x63CC55F49F88EB2FULL },
+    { 0xC2781F49FFCFA6D5ULL, 0x3CBF6B71C76B25FBULL }, { 0xF316271C7FC3908AULL, 0x8BEF464E3945EF7AULL },
+    { 0x97EDD871CFDA3A56ULL, 0x97758BF0E3CBB5ACULL }, { 0xBDE94E8E43D0C8ECULL, 0x3D52EEED1CBEA317ULL },
+    { 0xED63A231D4C4FB27ULL, 0x4CA7AAA863EE4BDDULL }, { 0x945E455F24FB1CF8ULL, 0x8FE8CAA93E74EF6AULL },
+    { 0xB975D6B6EE39E436ULL, 0xB3E2FD538E122B44ULL }, { 0xE7D34C64A9C85D44ULL, 0x60DBBCA87196B616ULL },
+    { 0x90E40FBEEA1D3A4AULL, 0xBC8955E946FE31CDULL }, { 0xB51D13AEA4A488DDULL, 0x6BABAB6398BDBE41ULL },
+    { 0xE264589A4DCDAB14ULL, 0xC696963C7EED2DD1ULL }, { 0x8D7EB76070A08AECULL, 0xFC1E1DE5CF543CA2ULL },
+    { 0xB0DE65388CC8ADA8ULL, 0x3B25A55F43294BCBULL }, { 0xDD15FE86AFFAD912ULL, 0x49EF0EB713F39EBEULL },
+    { 0x8A2DBF142DFCC7ABULL, 0x6E3569326C784337ULL }, { 0xACB92ED9397BF996ULL, 0x49C2C37F07965404ULL },
+    { 0xD7E77A8F87DAF7FBULL, 0xDC33745EC97BE906ULL }, { 0x86F0AC99B4E8DAFDULL, 0x69A028BB3DED71A3ULL },
+    { 0xA8ACD7C0222311BCULL, 0xC40832EA0D68CE0CULL }, { 0xD2D80DB02AABD62BULL, 0xF50A3FA490C30190ULL },
+    { 0x83C7088E1AAB65DBULL, 0x792667C6DA79E0FAULL }, { 0xA4B8CAB1A1563F52ULL, 0x577001B891185938ULL },
+    { 0xCDE6FD5E09ABCF26ULL, 0xED4C0226B55E6F86ULL }, { 0x80B05E5AC60B6178ULL, 0x544F8158315B05B4ULL },
+    { 0xA0DC75F1778E39D6ULL, 0x696361AE3DB1C721ULL }, { 0xC913936DD571C84CULL, 0x03BC3A19CD1E38E9ULL },
+    { 0xFB5878494ACE3A5FULL, 0x04AB48A04065C723ULL }, { 0x9D174B2DCEC0E47BULL, 0x62EB0D64283F9C76ULL },
+    { 0xC45D1DF942711D9AULL, 0x3BA5D0BD324F8394ULL }, { 0xF5746577930D6500ULL, 0xCA8F44EC7EE36479ULL },
+    { 0x9968BF6ABBE85F20ULL, 0x7E998B13CF4E1ECBULL }, { 0xBFC2EF456AE276E8ULL, 0x9E3FEDD8C321A67EULL },
+    { 0xEFB3AB16C59B14A2ULL, 0xC5CFE94EF3EA101EULL }, { 0x95D04AEE3B80ECE5ULL, 0xBBA1F1D158724A12ULL },
+    { 0xBB445DA9CA61281FULL, 0x2A8A6E45AE8EDC97ULL }, { 0xEA1575143CF97226ULL, 0xF52D09D71A3293BDULL },
+    { 0x924D692CA61BE758ULL, 0x593C2626705F9C56ULL }, { 0xB6E0C377CFA2E12EULL, 0x6F8B2FB00C77836CULL },
+    { 0xE498F455C38B997AULL, 0x0B6DFB9C0F956447ULL }, { 0x8EDF98B59A373FECULL, 0x4724BD4189BD5EACULL },
+    { 0xB2977EE300C50FE7ULL, 0x58EDEC91EC2CB657ULL }, { 0xDF3D5E9BC0F653E1ULL, 0x2F2967B66737E3EDULL },
+    { 0x8B865B215899F46CULL, 0xBD79E0D20082EE74ULL }, { 0xAE67F1E9AEC07187ULL, 0xECD8590680A3AA11ULL },
+    { 0xDA01EE641A708DE9ULL, 0xE80E6F4820CC9495ULL }, { 0x884134FE908658B2ULL, 0x3109058D147FDCDDULL },
+    { 0xAA51823E34A7EEDEULL, 0xBD4B46F0599FD415ULL }, { 0xD4E5E2CDC1D1EA96ULL, 0x6C9E18AC7007C91AULL },
+    { 0x850FADC09923329EULL, 0x03E2CF6BC604DDB0ULL }, { 0xA6539930BF6BFF45ULL, 0x84DB8346B786151CULL },
+    { 0xCFE87F7CEF46FF16ULL, 0xE612641865679A63ULL }, { 0x81F14FAE158C5F6EULL, 0x4FCB7E8F3F60C07EULL },
+    { 0xA26DA3999AEF7749ULL, 0xE3BE5E330F38F09DULL }, { 0xCB090C8001AB551CULL, 0x5CADF5BFD3072CC5ULL },
+    { 0xFDCB4FA002162A63ULL, 0x73D9732FC7C8F7F6ULL }, { 0x9E9F11C4014DDA7EULL, 0x2867E7FDDCDD9AFAULL },
+    { 0xC646D63501A1511DULL, 0xB281E1FD541501B8ULL }, { 0xF7D88BC24209A565ULL, 0x1F225A7CA91A4226ULL },
+    { 0x9AE757596946075FULL, 0x3375788DE9B06958ULL }, { 0xC1A12D2FC3978937ULL, 0x0052D6B1641C83AEULL },
+    { 0xF209787BB47D6B84ULL, 0xC0678C5DBD23A49AULL }, { 0x9745EB4D50CE6332ULL, 0xF840B7BA963646E0ULL },
+    { 0xBD176620A501FBFFULL, 0xB650E5A93BC3D898ULL }, { 0xEC5D3FA8CE427AFFULL, 0xA3E51F138AB4CEBEULL },
+    { 0x93BA47C980E98CDFULL, 0xC66F336C36B10137ULL }, { 0xB8A8D9BBE123F017ULL, 0xB80B0047445D4184ULL },
+    { 0xE6D3102AD96CEC1DULL, 0xA60DC059157491E5ULL }, { 0x9043EA1AC7E41392ULL, 0x87C89837AD68DB2FULL },
+    { 0xB454E4A179DD1877ULL, 0x29BABE4598C311FBULL }, { 0xE16A1DC9D8545E94ULL, 0xF4296DD6FEF3D67AULL },
+    { 0x8CE2529E2734BB1DULL, 0x1899E4A65F58660CULL }, { 0xB01AE745B101E9E4ULL, 0x5EC05DCFF72E7F8FULL },
+    { 0xDC21A1171D42645DULL, 0x76707543F4FA1F73ULL }, { 0x899504AE72497EBAULL, 0x6A06494A791C53A8ULL },
+    { 0xABFA45DA0EDBDE69ULL, 0x0487DB9D17636892ULL }, { 0xD6F8D7509292D603ULL, 0x45A9D2845D3C42B6ULL },
+    { 0x865B86925B9BC5C2ULL, 0x0B8A2392BA45A9B2ULL }, { 0xA7F26836F282B732ULL, 0x8E6CAC7768D7141EULL },
+    { 0xD1EF0244AF2364FFULL, 0x3207D795430CD926ULL }, { 0x8335616AED761F1FULL, 0x7F44E6BD49E807B8ULL },
+    { 0xA402B9C5A8D3A6E7ULL, 0x5F16206C9C6209A6ULL }, { 0xCD036837130890A1ULL, 0x36DBA887C37A8C0FULL },
+    { 0x802221226BE55A64ULL, 0xC2494954DA2C9789ULL }, { 0xA02AA96B06DEB0FDULL, 0xF2DB9BAA10B7BD6CULL },
+    { 0xC83553C5C8965D3DULL, 0x6F92829494E5ACC7ULL }, { 0xFA42A8B73ABBF48CULL, 0xCB772339BA1F17F9ULL },
+    { 0x9C69A97284B578D7ULL, 0xFF2A760414536EFBULL }, { 0xC38413CF25E2D70DULL, 0xFEF5138519684ABAULL },
+    { 0xF46518C2EF5B8CD1ULL, 0x7EB258665FC25D69ULL }, { 0x98BF2F79D5993802ULL, 0xEF2F773FFBD97A61ULL },
+    { 0xBEEEFB584AFF8603ULL, 0xAAFB550FFACFD8FAULL }, { 0xEEAABA2E5DBF6784ULL, 0x95BA2A53F983CF38ULL },
+    { 0x952AB45CFA97A0B2ULL, 0xDD945A747BF26183ULL }, { 0xBA756174393D88DFULL, 0x94F971119AEEF9E4ULL },
+    { 0xE912B9D1478CEB17ULL, 0x7A37CD5601AAB85DULL }, { 0x91ABB422CCB812EEULL, 0xAC62E055C10AB33AULL },
+    { 0xB616A12B7FE617AAULL, 0x577B986B314D6009ULL }, { 0xE39C49765FDF9D94ULL, 0xED5A7E85FDA0B80BULL },
+    { 0x8E41ADE9FBEBC27DULL, 0x14588F13BE847307ULL }, { 0xB1D219647AE6B31CULL, 0x596EB2D8AE258FC8ULL },
+    { 0xDE469FBD99A05FE3ULL, 0x6FCA5F8ED9AEF3BBULL }, { 0x8AEC23D680043BEEULL, 0x25DE7BB9480D5854ULL },
+    { 0xADA72CCC20054AE9ULL, 0xAF561AA79A10AE6AULL }, { 0xD910F7FF28069DA4ULL, 0x1B2BA1518094DA04ULL },
+    { 0x87AA9AFF79042286ULL, 0x90FB44D2F05D0842ULL }, { 0xA99541BF57452B28ULL, 0x353A1607AC744A53ULL },
+    { 0xD3FA922F2D1675F2ULL, 0x42889B8997915CE8ULL }, { 0x847C9B5D7C2E09B7ULL, 0x69956135FEBADA11ULL },
+    { 0xA59BC234DB398C25ULL, 0x43FAB9837E699095ULL }, { 0xCF02B2C21207EF2EULL, 0x94F967E45E03F4BBULL },
+    { 0x8161AFB94B44F57DULL, 0x1D1BE0EEBAC278F5ULL }, { 0xA1BA1BA79E1632DCULL, 0x6462D92A69731732ULL },
+    { 0xCA28A291859BBF93ULL, 0x7D7B8F7503CFDCFEULL }, { 0xFCB2CB35E702AF78ULL, 0x5CDA735244C3D43EULL },
+    { 0x9DEFBF01B061ADABULL, 0x3A0888136AFA64A7ULL }, { 0xC56BAEC21C7A1916ULL, 0x088AAA1845B8FDD0ULL },
+    { 0xF6C69A72A3989F5BULL, 0x8AAD549E57273D45ULL }, { 0x9A3C2087A63F6399ULL, 0x36AC54E2F678864BULL },
+    { 0xC0CB28A98FCF3C7FULL, 0x84576A1BB416A7DDULL }, { 0xF0FDF2D3F3C30B9FULL, 0x656D44A2A11C51D5ULL },
+    { 0x969EB7C47859E743ULL, 0x9F644AE5A4B1B325ULL }, { 0xBC4665B596706114ULL, 0x873D5D9F0DDE1FEEULL },
+    { 0xEB57FF22FC0C7959ULL, 0xA90CB506D155A7EAULL }, { 0x9316FF75DD87CBD8ULL, 0x09A7F12442D588F2ULL },
+    { 0xB7DCBF5354E9BECEULL, 0x0C11ED6D538AEB2FULL }, { 0xE5D3EF282A242E81ULL, 0x8F1668C8A86DA5FAULL },
+    { 0x8FA475791A569D10ULL, 0xF96E017D694487BCULL }, { 0xB38D92D760EC4455ULL, 0x37C981DCC395A9ACULL },
+    { 0xE070F78D3927556AULL, 0x85BBE253F47B1417ULL }, { 0x8C469AB843B89562ULL, 0x93956D7478CCEC8EULL },
+    { 0xAF58416654A6BABBULL, 0x387AC8D1970027B2ULL }, { 0xDB2E51BFE9D0696AULL, 0x06997B05FCC0319EULL },
+    { 0x88FCF317F22241E2ULL, 0x441FECE3BDF81F03ULL }, { 0xAB3C2FDDEEAAD25AULL, 0xD527E81CAD7626C3ULL },
+    { 0xD60B3BD56A5586F1ULL, 0x8A71E223D8D3B074ULL }, { 0x85C7056562757456ULL, 0xF6872D5667844E49ULL },
+    { 0xA738C6BEBB12D16CULL, 0xB428F8AC016561DBULL }, { 0xD106F86E69D785C7ULL, 0xE13336D701BEBA52ULL },
+    { 0x82A45B450226B39CULL, 0xECC0024661173473ULL }, { 0xA34D721642B06084ULL, 0x27F002D7F95D0190ULL },
+    { 0xCC20CE9BD35C78A5ULL, 0x31EC038DF7B441F4ULL }, { 0xFF290242C83396CEULL, 0x7E67047175A15271ULL },
+    { 0x9F79A169BD203E41ULL, 0x0F0062C6E984D386ULL }, { 0xC75809C42C684DD1ULL, 0x52C07B78A3E60868ULL },
+    { 0xF92E0C3537826145ULL, 0xA7709A56CCDF8A82ULL }, { 0x9BBCC7A142B17CCBULL, 0x88A66076400BB691ULL },
+    { 0xC2ABF989935DDBFEULL, 0x6ACFF893D00EA435ULL }, { 0xF356F7EBF83552FEULL, 0x0583F6B8C4124D43ULL },
+    { 0x98165AF37B2153DEULL, 0xC3727A337A8B704AULL }, { 0xBE1BF1B059E9A8D6ULL, 0x744F18C0592E4C5CULL },
+    { 0xEDA2EE1C7064130CULL, 0x1162DEF06F79DF73ULL }, { 0x9485D4D1C63E8BE7ULL, 0x8ADDCB5645AC2BA8ULL },
+    { 0xB9A74A0637CE2EE1ULL, 0x6D953E2BD7173692ULL }, { 0xE8111C87C5C1BA99ULL, 0xC8FA8DB6CCDD0437ULL },
+    { 0x910AB1D4DB9914A0ULL, 0x1D9C9892400A22A2ULL }, { 0xB54D5E4A127F59C8ULL, 0x2503BEB6D00CAB4BULL },
+    { 0xE2A0B5DC971F303AULL, 0x2E44AE64840FD61DULL }, { 0x8DA471A9DE737E24ULL, 0x5CEAECFED289E5D2ULL },
+    { 0xB10D8E1456105DADULL, 0x7425A83E872C5F47ULL }, { 0xDD50F1996B947518ULL, 0xD12F124E28F77719ULL },
+    { 0x8A5296FFE33CC92FULL, 0x82BD6B70D99AAA6FULL }, { 0xACE73CBFDC0BFB7BULL, 0x636CC64D1001550BULL },
+    { 0xD8210BEFD30EFA5AULL, 0x3C47F7E05401AA4EULL }, { 0x8714A775E3E95C78ULL, 0x65ACFAEC34810A71ULL },
+    { 0xA8D9D1535CE3B396ULL, 0x7F1839A741A14D0DULL }, { 0xD31045A8341CA07CULL, 0x1EDE48111209A050ULL },
+    { 0x83EA2B892091E44DULL, 0x934AED0AAB460432ULL }, { 0xA4E4B66B68B65D60ULL, 0xF81DA84D5617853FULL },
+    { 0xCE1DE40642E3F4B9ULL, 0x36251260AB9D668EULL }, { 0x80D2AE83E9CE78F3ULL, 0xC1D72B7C6B426019ULL },
+    { 0xA1075A24E4421730ULL, 0xB24CF65B8612F81FULL }, { 0xC94930AE1D529CFCULL, 0xDEE033F26797B627ULL },
+    { 0xFB9B7CD9A4A7443CULL, 0x169840EF017DA3B1ULL }, { 0x9D412E0806E88AA5ULL, 0x8E1F289560EE864EULL },
+    { 0xC491798A08A2AD4EULL, 0xF1A6F2BAB92A27E2ULL }, { 0xF5B5D7EC8ACB58A2ULL, 0xAE10AF696774B1DBULL },
+    { 0x9991A6F3D6BF1765ULL, 0xACCA6DA1E0A8EF29ULL }, { 0xBFF610B0CC6EDD3FULL, 0x17FD090A58D32AF3ULL },
+    { 0xEFF394DCFF8A948EULL, 0xDDFC4B4CEF07F5B0ULL }, { 0x95F83D0A1FB69CD9ULL, 0x4ABDAF101564F98EULL },
+    { 0xBB764C4CA7A4440FULL, 0x9D6D1AD41ABE37F1ULL }, { 0xEA53DF5FD18D5513ULL, 0x84C86189216DC5EDULL },
+    { 0x92746B9BE2F8552CULL, 0x32FD3CF5B4E49BB4ULL }, { 0xB7118682DBB66A77ULL, 0x3FBC8C33221DC2A1ULL },
+    { 0xE4D5E82392A40515ULL, 0x0FABAF3FEAA5334AULL }, { 0x8F05B1163BA6832DULL, 0x29CB4D87F2A7400EULL },
+    { 0xB2C71D5BCA9023F8ULL, 0x743E20E9EF511012ULL }, { 0xDF78E4B2BD342CF6ULL, 0x914DA9246B255416ULL },
+    { 0x8BAB8EEFB6409C1AULL, 0x1AD089B6C2F7548EULL }, { 0xAE9672ABA3D0C320ULL, 0xA184AC2473B529B1ULL },
+    { 0xDA3C0F568CC4F3E8ULL, 0xC9E5D72D90A2741EULL }, { 0x8865899617FB1871ULL, 0x7E2FA67C7A658892ULL },
+    { 0xAA7EEBFB9DF9DE8DULL, 0xDDBB901B98FEEAB7ULL }, { 0xD51EA6FA85785631ULL, 0x552A74227F3EA565ULL },
+    { 0x8533285C936B35DEULL, 0xD53A88958F87275FULL }, { 0xA67FF273B8460356ULL, 0x8A892ABAF368F137ULL },
+    { 0xD01FEF10A657842CULL, 0x2D2B7569B0432D85ULL }, { 0x8213F56A67F6B29BULL, 0x9C3B29620E29FC73ULL },
+    { 0xA298F2C501F45F42ULL, 0x8349F3BA91B47B8FULL }, { 0xCB3F2F7642717713ULL, 0x241C70A936219A73ULL },
+    { 0xFE0EFB53D30DD4D7ULL, 0xED238CD383AA0110ULL }, { 0x9EC95D1463E8A506ULL, 0xF4363804324A40AAULL },
+    { 0xC67BB4597CE2CE48ULL, 0xB143C6053EDCD0D5ULL }, { 0xF81AA16FDC1B81DAULL, 0xDD94B7868E94050AULL },
+    { 0x9B10A4E5E9913128ULL, 0xCA7CF2B4191C8326ULL }, { 0xC1D4CE1F63F57D72ULL, 0xFD1C2F611F63A3F0ULL },
+    { 0xF24A01A73CF2DCCFULL, 0xBC633B39673C8CECULL }, { 0x976E41088617CA01ULL, 0xD5BE0503E085D813ULL },
+    { 0xBD49D14AA79DBC82ULL, 0x4B2D8644D8A74E18ULL }, { 0xEC9C459D51852BA2ULL, 0xDDF8E7D60ED1219EULL },
+    { 0x93E1AB8252F33B45ULL, 0xCABB90E5C942B503ULL }, { 0xB8DA1662E7B00A17ULL, 0x3D6A751F3B936243ULL },
+    { 0xE7109BFBA19C0C9DULL, 0x0CC512670A783AD4ULL }, { 0x906A617D450187E2ULL, 0x27FB2B80668B24C5ULL },
+    { 0xB484F9DC9641E9DAULL, 0xB1F9F660802DEDF6ULL }, { 0xE1A63853BBD26451ULL, 0x5E7873F8A0396973ULL },
+    { 0x8D07E33455637EB2ULL, 0xDB0B487B6423E1E8ULL }, { 0xB049DC016ABC5E5FULL, 0x91CE1A9A3D2CDA62ULL },
+    { 0xDC5C5301C56B75F7ULL, 0x7641A140CC7810FBULL }, { 0x89B9B3E11B6329BAULL, 0xA9E904C87FCB0A9DULL },
+    { 0xAC2820D9623BF429ULL, 0x546345FA9FBDCD44ULL }, { 0xD732290FBACAF133ULL, 0xA97C177947AD4095ULL },
+    { 0x867F59A9D4BED6C0ULL, 0x49ED8EABCCCC485DULL }, { 0xA81F301449EE8C70ULL, 0x5C68F256BFFF5A74ULL },
+    { 0xD226FC195C6A2F8CULL, 0x73832EEC6FFF3111ULL }, { 0x83585D8FD9C25DB7ULL, 0xC831FD53C5FF7EABULL },
+    { 0xA42E74F3D032F525ULL, 0xBA3E7CA8B77F5E55ULL }, { 0xCD3A1230C43FB26FULL, 0x28CE1BD2E55F35EBULL },
+    { 0x80444B5E7AA7CF85ULL, 0x7980D163CF5B81B3ULL }, { 0xA0555E361951C366ULL, 0xD7E105BCC332621FULL },
+    { 0xC86AB5C39FA63440ULL, 0x8DD9472BF3FEFAA7ULL }, { 0xFA856334878FC150ULL, 0xB14F98F6F0FEB951ULL },
+    { 0x9C935E00D4B9D8D2ULL, 0x6ED1BF9A569F33D3ULL }, { 0xC3B8358109E84F07ULL, 0x0A862F80EC4700C8ULL },
+    { 0xF4A642E14C6262C8ULL, 0xCD27BB612758C0FAULL }, { 0x98E7E9CCCFBD7DBDULL, 0x8038D51CB897789CULL },
+    { 0xBF21E44003ACDD2CULL, 0xE0470A63E6BD56C3ULL }, { 0xEEEA5D5004981478ULL, 0x1858CCFCE06CAC74ULL },
+    { 0x95527A5202DF0CCBULL, 0x0F37801E0C43EBC8ULL }, { 0xBAA718E68396CFFDULL, 0xD30560258F54E6BAULL },
+    { 0xE950DF20247C83FDULL, 0x47C6B82EF32A2069ULL }, { 0x91D28B7416CDD27EULL, 0x4CDC331D57FA5441ULL },
+    { 0xB6472E511C81471DULL, 0xE0133FE4ADF8E952ULL }, { 0xE3D8F9E563A198E5ULL, 0x58180FDDD97723A6ULL },
+    { 0x8E679C2F5E44FF8FULL, 0x570F09EAA7EA7648ULL }
+};
+
+static const double parse_exact_pow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static pthread_once_t parse_locale_once = PTHREAD_ONCE_INIT;
+static locale_t parse_locale = (locale_t)0;
+
+static void parse_locale_init(void) {
+    parse_locale = newlocale(LC_NUMERIC_MASK, "C", (locale_t)0);
+}
+
+/* Switch this thread to the "C" numeric locale; returns the previous one */
+static locale_t use_c_numeric_locale(void) {
+    pthread_once(&parse_locale_once, parse_locale_init);
+    return parse_locale ? uselocale(parse_locale) : (locale_t)0;
+}
+
+static void restore_locale(locale_t previous) {
+    if (parse_locale) uselocale(previous);
+}
+
+/* Correctly rounded value of the validated number [p, end) */
+static int parse_double_slow(const char *p, const char *end, double *value) {
+    char local[64];
+    size_t len = (size_t)(end - p);
+    char *text = local;
+    if (len >= sizeof(local)) {
+        text = (char*)malloc(len + 1);
+        if (!text) return -1;
+    }
+    memcpy(text, p, len);
+    text[len] = '\0';
+    
+    locale_t previous = use_c_numeric_locale();
+    *value = strtod(text, NULL);
+    restore_locale(previous);
+    
+    if (text != local) free(text);
+    return 0;
+}
+
+/*
+ * Eisel-Lemire: bits of the double nearest to w * 10^q (w > 0), computed
+ * from the top bits of w * 5^q. Values below the smallest subnormal give
+ * 0 and values above DBL_MAX give infinity.
+ */
+static uint64_t parse_eisel_lemire(uint64_t w, int q) {
+    if (q < PARSE_MIN_POW5) return 0;
+    if (q > PARSE_MAX_POW5) return 0x7FFULL << 52;
+    
+    int lz = __builtin_clzll(w);
+    w <<= lz;
+    
+    /* 64 x 128-bit product; the low word only matters near a bit boundary */
+    const uint64_t *pow5 = parse_pow5_128[q - PARSE_MIN_POW5];
+    unsigned __int128 first = (unsigned __int128)w * pow5[0];
+    uint64_t high = (uint64_t)(first >> 64);
+    uint64_t low = (uint64_t)first;
+    const uint64_t precision_mask = 0xFFFFFFFFFFFFFFFFULL >> 55;
+    if ((high & precision_mask) == precision_mask) {
+        uint64_t second = (uint64_t)(((unsigned __int128)w * pow5[1]) >> 64);
+        low += second;
+        if (second > low) high++;
+    }
+    
+    /* 54 significant bits plus a rounding bit; floor(log2(10^q)) + 63 */
+    int upper = (int)(high >> 63);
+    int shift = upper + 64 - 52 - 3;
+    uint64_t mantissa = high >> shift;
+    int power2 = (((152170 + 65536) * q) >> 16) + 63 + upper - lz + 1023;
+    
+    if (power2 <= 0) {
+        /* Subnormal: shift down to the minimum exponent, then round */
+        if (-power2 + 1 >= 64) return 0;
+        mantissa >>= -power2 + 1;
+        mantissa += (mantissa & 1);
+        mantissa >>= 1;
+        power2 = (mantissa < (1ULL << 52)) ? 0 : 1;
+        return ((uint64_t)power2 << 52) | (mantissa & ((1ULL << 52) - 1));
+    }
+    
+    /* An exact halfway product (only possible for small q) rounds to even */
+    if (low <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1 &&
+        (mantissa << shift) == high) {
+        mantissa &= ~1ULL;
+    }
+    
+    mantissa += (mantissa & 1);
+    mantissa >>= 1;
+    if (mantissa >= (2ULL << 52)) {
+        mantissa = 1ULL << 52;
+        power2++;
+    }
+    if (power2 >= 0x7FF) return 0x7FFULL << 52;
+    
+    return ((uint64_t)power2 << 52) | (mantissa & ((1ULL << 52) - 1));
+}
+
+/* Case-insensitive match of word at p; returns the end of the match or NULL */
+static const char* parse_word(const char *p, const char *end, const char *word) {
+    for (; *word; word++, p++) {
+        if (p == end || (*p | 0x20) != *word) return NULL;
+    }
+    return p;
+}
+
+const char* pca_parse_double(const char *begin, const char *end, double *value) {
+    const char *p = begin;
+    int negative = 0;
+    if (p < end && (*p == '+' || *p == '-')) {
+        negative = (*p == '-');
+        p++;
+    }
+    
+    /* inf, infinity, nan */
+    if (p < end && ((*p | 0x20) == 'i' || (*p | 0x20) == 'n')) {
+        const char *q;
+        if ((q = parse_word(p, end, "nan")) != NULL) {
+            *value = negative ? -NAN : NAN;
+            return q;
+        }
+        if ((q = parse_word(p, end, "inf")) != NULL) {
+            const char *longer = parse_word(q, end, "inity");
+            *value = negative ? -INFINITY : INFINITY;
+            return longer ? longer : q;
+        }
+        return NULL;
+    }
+    
+    unsigned long long mantissa = 0;
+    int digits = 0;             /* Significant digits kept in mantissa */
+    int truncated = 0;          /* Non-zero digits beyond PARSE_MAX_DIGITS */
+    int exponent = 0;           /* Power of ten applied to mantissa */
+    int seen_digit = 0;
+    
+    for (; p < end && *p >= '0' && *p <= '9'; p++) {
+        int d = *p - '0';
+        seen_digit = 1;
+        if (digits < PARSE_MAX_DIGITS) {
+            if (mantissa == 0 && d == 0) continue;
+            mantissa = mantissa * 10 + d;
+            digits++;
+        } else {
+            exponent++;
+            if (d) truncated = 1;
+        }
+    }
+    
+    if (p < end && *p == '.') {
+        for (p++; p < end && *p >= '0' && *p <= '9'; p++) {
+            int d = *p - '0';
+            seen_digit = 1;
+            if (digits < PARSE_MAX_DIGITS) {
+                exponent--;
+                if (mantissa == 0 && d == 0) continue;
+                mantissa = mantissa * 10 + d;
+                digits++;
+            } else if (d) {
+                truncated = 1;
+            }
+        }
+    }
+    
+    if (!seen_digit) return NULL;
+    
+    /* An 'e' without digits is not part of the number */
+    if (p < end && (*p | 0x20) == 'e') {
+        const char *q = p + 1;
+        int exp_negative = 0;
+        if (q < end && (*q == '+' || *q == '-')) {
+            exp_negative = (*q == '-');
+            q++;
+        }
+        if (q < end && *q >= '0' && *q <= '9') {
+            int exp_value = 0;
+            for (; q < end && *q >= '0' && *q <= '9'; q++) {
+                if (exp_value < 100000) exp_value = exp_value * 10 + (*q - '0');
+            }
+            exponent += exp_negative ? -exp_value : exp_value;
+            p = q;
+        }
+    }
+    
+    double result;
+    if (mantissa == 0) {
+        result = 0.0;
+    } else if (!truncated && mantissa <= PARSE_MAX_EXACT_MANTISSA &&
+               exponent >= -22 && exponent <= 22) {
+        result = (double)mantissa;
+        result = (exponent < 0) ? result / parse_exact_pow10[-exponent]
+                                : result * parse_exact_pow10[exponent];
+    } else if (!truncated && exponent > 22 && exponent <= 22 + 15 &&
+               mantissa <= PARSE_MAX_EXACT_MANTISSA /
+                            (unsigned long long)parse_exact_pow10[exponent - 22]) {
+        /* Move the excess exponent into the mantissa while it stays exact */
+        result = (double)(mantissa * (unsigned long long)parse_exact_pow10[exponent - 22]) * 1e22;
+    } else {
+        /* A cut mantissa lies in [w, w + 1); both ends must round alike */
+        uint64_t bits = parse_eisel_lemire(mantissa, exponent);
+        if (truncated && parse_eisel_lemire(mantissa + 1, exponent) != bits) {
+            if (parse_double_slow(begin, p, value) != 0) return NULL;
+            return p;
+        }
+        memcpy(&result, &bits, sizeof(result));
+    }
+    
+    *value = negative ? -result : result;
+    return p;
+}
+
+/*
+ * Number formatting. Shortest output uses Grisu2 (Loitsch, "Printing
+ * floating-point numbers quickly and accurately with integers"): the
+ * value and its rounding boundaries are scaled by a cached power of ten
+ * into 64-bit fixed point and digits are generated until the result is
+ * inside the boundaries, so it always reads back to the same double and
+ * is almost always the shortest such string. Fixed precision scales by
+ * 10^precision and formats the rounded integer, falling back to printf
+ * only when the value is too large or too close to a rounding tie.
+ */
+typedef struct {
+    uint64_t f;                 /* Significand */
+    int e;                      /* Binary exponent */
+} DiyFp;
+
+typedef struct {
+    uint64_t f;
+    int e;
+    int k;                      /* Decimal exponent: 10^k ~= f * 2^e */
+} CachedPower;
+
+/* Normalized, rounded 10^k for k = -300, -292, ..., 340 */
+static const CachedPower format_cached_powers[] = {
+    { 0xAB70FE17C79AC6CAULL, -1060, -300 },
+    { 0xFF77B1FCBEBCDC4FULL, -1034, -292 },
+    { 0xBE5691EF416BD60CULL, -1007, -284 },
+    { 0x8DD01FAD907FFC3CULL,  -980, -276 },
+    { 0xD3515C2831559A83ULL,  -954, -268 },
+    { 0x9D71AC8FADA6C9B5ULL,  -927, -260 },
+    { 0xEA9C227723EE8BCBULL,  -901, -252 },
+    { 0xAECC49914078536DULL,  -874, -244 },
+    { 0x823C12795DB6CE57ULL,  -847, -236 },
+    { 0xC21094364DFB5637ULL,  -821, -228 },
+    { 0x9096EA6F3848984FULL,  -794, -220 },
+    { 0xD77485CB25823AC7ULL,  -768, -212 },
+    { 0xA086CFCD97BF97F4ULL,  -741, -204 },
+    { 0xEF340A98172AACE5ULL,  -715, -196 },
+    { 0xB23867FB2A35B28EULL,  -688, -188 },
+    { 0x84C8D4DFD2C63F3BULL,  -661, -180 },
+    { 0xC5DD44271AD3CDBAULL,  -635, -172 },
+    { 0x936B9FCEBB25C996ULL,  -608, -164 },
+    { 0xDBAC6C247D62A584ULL,  -582, -156 },
+    { 0xA3AB66580D5FDAF6ULL,  -555, -148 },
+    { 0xF3E2F893DEC3F126ULL,  -529, -140 },
+    { 0xB5B5ADA8AAFF80B8ULL,  -502, -132 },
+    { 0x87625F056C7C4A8BULL,  -475, -124 },
+    { 0xC9BCFF6034C13053ULL,  -449, -116 },
+    { 0x964E858C91BA2655ULL,  -422, -108 },
+    { 0xDFF9772470297EBDULL,  -396, -100 },
+    { 0xA6DFBD9FB8E5B88FULL,  -369,  -92 },
+    { 0xF8A95FCF88747D94ULL,  -343,  -84 },
+    { 0xB94470938FA89BCFULL,  -316,  -76 },
+    { 0x8A08F0F8BF0F156BULL,  -289,  -68 },
+    { 0xCDB02555653131B6ULL,  -263,  -60 },
+    { 0x993FE2C6D07B7FACULL,  -236,  -52 },
+    { 0xE45C10C42A2B3B06ULL,  -210,  -44 },
+    { 0xAA242499697392D3ULL,  -183,  -36 },
+    { 0xFD87B5F28300CA0EULL,  -157,  -28 },
+    { 0xBCE5086492111AEBULL,  -130,  -20 },
+    { 0x8CBCCC096F5088CCULL,  -103,  -12 },
+    { 0xD1B71758E219652CULL,   -77,   -4 },
+    { 0x9C40000000000000ULL,   -50,    4 },
+    { 0xE8D4A51000000000ULL,   -24,   12 },
+    { 0xAD78EBC5AC620000ULL,     3,   20 },
+    { 0x813F3978F8940984ULL,    30,   28 },
+    { 0xC097CE7BC90715B3ULL,    56,   36 },
+    { 0x8F7E32CE7BEA5C70ULL,    83,   44 },
+    { 0xD5D238A4ABE98068ULL,   109,   52 },
+    { 0x9F4F2726179A2245ULL,   136,   60 },
+    { 0xED63A231D4C4FB27ULL,   162,   68 },
+    { 0xB0DE65388CC8ADA8ULL,   189,   76 },
+    { 0x83C7088E1AAB65DBULL,   216,   84 },
+    { 0xC45D1DF942711D9AULL,   242,   92 },
+    { 0x924D692CA61BE758ULL,   269,  100 },
+    { 0xDA01EE641A708DEAULL,   295,  108 },
+    { 0xA26DA3999AEF774AULL,   322,  116 },
+    { 0xF209787BB47D6B85ULL,   348,  124 },
+    { 0xB454E4A179DD1877ULL,   375,  132 },
+    { 0x865B86925B9BC5C2ULL,   402,  140 },
+    { 0xC83553C5C8965D3DULL,   428,  148 },
+    { 0x952AB45CFA97A0B3ULL,   455,  156 },
+    { 0xDE469FBD99A05FE3ULL,   481,  164 },
+    { 0xA59BC234DB398C25ULL,   508,  172 },
+    { 0xF6C69A72A3989F5CULL,   534,  180 },
+    { 0xB7DCBF5354E9BECEULL,   561,  188 },
+    { 0x88FCF317F22241E2ULL,   588,  196 },
+    { 0xCC20CE9BD35C78A5ULL,   614,  204 },
+    { 0x98165AF37B2153DFULL,   641,  212 },
+    { 0xE2A0B5DC971F303AULL,   667,  220 },
+    { 0xA8D9D1535CE3B396ULL,   694,  228 },
+    { 0xFB9B7CD9A4A7443CULL,   720,  236 },
+    { 0xBB764C4CA7A44410ULL,   747,  244 },
+    { 0x8BAB8EEFB6409C1AULL,   774,  252 },
+    { 0xD01FEF10A657842CULL,   800,  260 },
+    { 0x9B10A4E5E9913129ULL,   827,  268 },
+    { 0xE7109BFBA19C0C9DULL,   853,  276 },
+    { 0xAC2820D9623BF429ULL,   880,  284 },
+    { 0x80444B5E7AA7CF85ULL,   907,  292 },
+    { 0xBF21E44003ACDD2DULL,   933,  300 },
+    { 0x8E679C2F5E44FF8FULL,   960,  308 },
+    { 0xD433179D9C8CB841ULL,   986,  316 },
+    { 0x9E19DB92B4E31BA9ULL,  1013,  324 },
+    { 0xEB96BF6EBADF77D9ULL,  1039,  332 },
+    { 0xAF87023B9BF0EE6BULL,  1066,  340 },
+};
+
+#define FORMAT_CACHED_MIN_EXP (-300)
+#define FORMAT_CACHED_EXP_STEP 8
+#define FORMAT_ALPHA (-60)      /* Target range of the scaled exponent */
+#define FORMAT_GAMMA (-32)
+
+/* Upper 64 bits of the 128-bit product, rounded */
+static DiyFp diyfp_mul(DiyFp x, DiyFp y) {
+    uint64_t x_lo = x.f & 0xFFFFFFFFu, x_hi = x.f >> 32;
+    uint64_t y_lo = y.f & 0xFFFFFFFFu, y_hi = y.f >> 32;
+    uint64_t p0 = x_lo * y_lo, p1 = x_lo * y_hi, p2 = x_hi * y_lo, p3 = x_hi * y_hi;
+    uint64_t mid = (p0 >> 32) + (p1 & 0xFFFFFFFFu) + (p2 & 0xFFFFFFFFu) + (1u << 31);
+    DiyFp r = { p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32), x.e + y.e + 64 };
+    return r;
+}
+
+static DiyFp diyfp_normalize(DiyFp x) {
+    int shift = __builtin_clzll(x.f);
+    DiyFp r = { x.f << shift, x.e - shift };
+    return r;
+}
+
+/* Grisu2 digit generation; see Loitsch, section 5 */
+static void grisu2_round(char *buf, int len, uint64_t dist, uint64_t delta,
+                         uint64_t rest, uint64_t ten_k) {
+    while (rest < dist && delta - rest >= ten_k &&
+           (rest + ten_k < dist || dist - rest > rest + ten_k - dist)) {
+        buf[len - 1]--;
+        rest += ten_k;
+    }
+}
+
+static int grisu2_digits(char *buf, int *decimal_exponent, DiyFp m_minus, DiyFp w, DiyFp m_plus) {
+    uint64_t delta = m_plus.f - m_minus.f;
+    uint64_t dist = m_plus.f - w.f;
+    int shift = -m_plus.e;
+    uint64_t one = 1ULL << shift;
+    uint32_t p1 = (uint32_t)(m_plus.f >> shift);
+    uint64_t p2 = m_plus.f & (one - 1);
+    int len = 0;
+    
+    /* Integral part: p1 < 10^10 */
+    uint32_t pow10 = 1;
+    int n = 1;
+    while (n < 10 && p1 / pow10 >= 10) {
+        pow10 *= 10;
+        n++;
+    }
+    while (n > 0) {
+        buf[len++] = (char)('0' + p1 / pow10);
+        p1 %= pow10;
+        n--;
+        uint64_t rest = ((uint64_t)p1 << shift) + p2;
+        if (rest <= delta) {
+            *decimal_exponent += n;
+            grisu2_round(buf, len, dist, delta, rest, (uint64_t)pow10 << shift);
+            return len;
+        }
+        pow10 /= 10;
+    }
+    
+    /* Fractional part */
+    int m = 0;
+    for (;;) {
+        p2 *= 10;
+        buf[len++] = (char)('0' + (p2 >> shift));
+        p2 &= one - 1;
+        m++;
+        delta *= 10;
+        dist *= 10;
+        if (p2 <= delta) break;
+    }
+    *decimal_exponent -= m;
+    grisu2_round(buf, len, dist, delta, p2, one);
+    return len;
+}
+
+/* Shortest digits of a finite v > 0: v ~= digits * 10^decimal_exponent */
+static int grisu2(double v, char *buf, int *decimal_exponent) {
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    uint64_t fraction = bits & ((1ULL << 52) - 1);
+    int biased = (int)(bits >> 52) & 0x7FF;
+    
+    DiyFp x = (biased == 0) ? (DiyFp){ fraction, 1 - 1075 }
+                            : (DiyFp){ fraction | (1ULL << 52), biased - 1075 };
+    
+    /* Boundaries halfway to the neighbouring doubles */
+    int lower_closer = (fraction == 0 && biased > 1);
+    DiyFp m_plus = diyfp_normalize((DiyFp){ 2 * x.f + 1, x.e - 1 });
+    DiyFp m_minus = lower_closer ? (DiyFp){ 4 * x.f - 1, x.e - 2 }
+                                 : (DiyFp){ 2 * x.f - 1, x.e - 1 };
+    m_minus.f <<= m_minus.e - m_plus.e;
+    m_minus.e = m_plus.e;
+    DiyFp w = diyfp_normalize(x);
+    
+    /* Cached power bringing the exponent into [FORMAT_ALPHA, FORMAT_GAMMA] */
+    int f = FORMAT_ALPHA - m_plus.e - 1;
+    int k = (f * 78913) / (1 << 18) + (f > 0);
+    int index = (-FORMAT_CACHED_MIN_EXP + k + (FORMAT_CACHED_EXP_STEP - 1)) / FORMAT_CACHED_EXP_STEP;
+    const CachedPower *cached = &format_cached_powers[index];
+    DiyFp c = { cached->f, cached->e };
+    
+    DiyFp sw = diyfp_mul(w, c);
+    DiyFp sm = diyfp_mul(m_minus, c);
+    DiyFp sp = diyfp_mul(m_plus, c);
+    sm.f++;
+    sp.f--;
+    
+    *decimal_exponent = -cached->k;
+    return grisu2_digits(buf, decimal_exponent, sm, sw, sp);
+}
+
+/* Lay out len digits times 10^decimal_exponent as plain or e-notation text */
+static int format_digits(char *out, const char *digits, int len, int decimal_exponent) {
+    int point = len + decimal_exponent;     /* Digits before the decimal point */
+    char *p = out;
+    
+    if (point >= len && point <= 15) {
+        /* Integer: digits then zeros */
+        memcpy(p, digits, len);
+        memset(p + len, '0', point - len);
+        p += point;
+    } else if (point > 0 && point <= 15) {
+        memcpy(p, digits, point);
+        p[point] = '.';
+        memcpy(p + point + 1, digits + point, len - point);
+        p += len + 1;
+    } else if (point > -5 && point <= 0) {
+        *p++ = '0';
+        *p++ = '.';
+        memset(p, '0', -point);
+        p += -point;
+        memcpy(p, digits, len);
+        p += len;
+    } else {
+        *p++ = digits[0];
+        if (len > 1) {
+            *p++ = '.';
+            memcpy(p, digits + 1, len - 1);
+            p += len - 1;
+        }
+        int exp10 = point - 1;
+        *p++ = 'e';
+        *p++ = (exp10 < 0) ? '-' : '+';
+        if (exp10 < 0) exp10 = -exp10;
+        if (exp10 >= 100) *p++ = (char)('0' + exp10 / 100);
+        *p++ = (char)('0' + exp10 / 10 % 10);
+        *p++ = (char)('0' + exp10 % 10);
+    }
+    return (int)(p - out);
+}
+
+/* Fixed-point text of |v| with precision decimals; -1 if the fast path cannot decide */
+static int format_fixed(double v, int precision, char *out) {
+    if (precision > 15) return -1;
+    double scaled = fabs(v) * parse_exact_pow10[precision];
+    if (!(scaled < 4503599627370496.0)) return -1;  /* 2^52 */
+    
+    /* The product is within half an ulp of the exact value; stay away from ties */
+    double whole = floor(scaled);
+    double frac = scaled - whole;
+    if (fabs(frac - 0.5) <= scaled * 4e-16 + 1e-300) return -1;
+    uint64_t u = (uint64_t)whole + (frac > 0.5);
+    
+    uint64_t scale = (uint64_t)parse_exact_pow10[precision];
+    uint64_t int_part = u / scale;
+    uint64_t frac_part = u % scale;
+    
+    char tmp[24];
+    int n = 0;
+    do {
+        tmp[n++] = (char)('0' + int_part % 10);
+        int_part /= 10;
+    } while (int_part);
+    
+    char *p = out;
+    while (n > 0) *p++ = tmp[--n];
+    if (precision > 0) {
+        *p++ = '.';
+        for (int i = precision - 1; i >= 0; i--) {
+            p[i] = (char)('0' + frac_part % 10);
+            frac_part /= 10;
+        }
+        p += precision;
+    }
+    return (int)(p - out);
+}
+
+int pca_format_double(double value, int precision, char *out) {
+    if (precision > PCA_FORMAT_MAX_PRECISION) precision = PCA_FORMAT_MAX_PRECISION;
+    
+    if (isnan(value)) {
+        memcpy(out, "nan", 3);
+        return 3;
+    }
+    
+    char *p = out;
+    if (signbit(value)) *p++ = '-';
+    
+    if (isinf(value)) {
+        memcpy(p, "inf", 3);
+        return (int)(p - out) + 3;
+    }
+    
+    if (precision >= 0) {
+        int len = format_fixed(value, precision, p);
+        if (len >= 0) return (int)(p - out) + len;
+        locale_t previous = use_c_numeric_locale();
+        len = snprintf(out, PCA_FORMAT_MAX_CHARS, "%.*f", precision, value);
+        restore_locale(previous);
+        return len;
+    }
+    
+    if (value == 0.0) {
+        *p++ = '0';
+        return (int)(p - out);
+    }
+    
+    char digits[20];
+    int decimal_exponent;
+    int len = grisu2(fabs(value), digits, &decimal_exponent);
+    return (int)(p - out) + format_digits(p, digits, len, decimal_exponent);
+}
+
+/*
+ * Input files are read as one contiguous byte range. Regular files are
+ * mmapped; only pipes and special files are read into a heap buffer. Text
+ * is mapped read-only, which costs no commit charge, so a CSV larger than
+ * RAM + swap still maps. Binary matrix payloads ask for a private
+ * writable mapping instead, so the matrix can use it as its buffer and
+ * callers may still modify it (copy-on-write). CSV row boundaries come
+ * from memchr, which libc vectorizes, so the rows can be counted before
+ * parsing and the matrix allocated once at its final size.
+ */
+#define SOURCE_WRITABLE 1       /* Copy-on-write mapping for zero-copy payloads */
+#define SOURCE_MAPPED_ONLY 2    /* Fail instead of reading a pipe into memory */
+
+typedef struct {
+    const char *data;           /* File contents */
+    size_t size;                /* Bytes in data */
+    void *mapping;              /* mmap base (NULL if data was read) */
+    char *buffer;               /* Heap copy when the file cannot be mapped */
+} FileSource;
+
+static int file_source_open(const char *filename, FileSource *src, int flags) {
+    memset(src, 0, sizeof(*src));
+    
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        print_error("Failed to open file for reading");
+        return -1;
+    }
+    
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        print_error("Failed to read file");
+        close(fd);
+        return -1;
+    }
+    
+    if (S_ISREG(st.st_mode)) {
+        if (st.st_size == 0) {
+            close(fd);
+            return 0;
+        }
+        
+        int prot = (flags & SOURCE_WRITABLE) ? PROT_READ | PROT_WRITE : PROT_READ;
+        void *map = mmap(NULL, (size_t)st.st_size, prot, MAP_PRIVATE, fd, 0);
+        close(fd);
+        
+        /* Reading a file too big to map into the heap cannot work either */
+        if (map == MAP_FAILED) {
+            print_error("Failed to map file");
+            return -1;
+        }
+        madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+        src->mapping = map;
+        src->data = (const char*)map;
+        src->size = (size_t)st.st_size;
+        return 0;
+    }
+    
+    if (flags & SOURCE_MAPPED_ONLY) {
+        print_error("Input must be a regular file");
+        close(fd);
+        return -1;
+    }
+    
+    /* Not mappable: read everything into a growing buffer */
+    size_t capacity = 0;
+    ssize_t got = 0;
+    do {
+        if (src->size == capacity) {
+            size_t new_capacity = capacity ? capacity * 2 : (1 << 20);
+            char *grown = (char*)realloc(src->buffer, new_capacity);
+            if (!grown) {
+                print_error("Failed to allocate CSV buffer");
+                free(src->buffer);
+                close(fd);
+                return -1;
+            }
+            src->buffer = grown;
+            capacity = new_capacity;
+        }
+        got = read(fd, src->buffer + src->size, capacity - src->size);
+        if (got > 0) src->size += (size_t)got;
+    } while (got > 0);
+    close(fd);
+    
+    if (got < 0) {
+        print_error("Failed to read file");
+        free(src->buffer);
+        return -1;
+    }
+    src->data = src->buffer;
+    return 0;
+}
+
+static void file_source_close(FileSource *src) {
+    if (src->mapping) munmap(src->mapping, src->size);
+    free(src->buffer);
+    memset(src, 0, sizeof(*src));
+}
+
+/* End of the line starting at p (position of '\n', or end) */
+static const char* csv_line_end(const char *p, const char *end) {
+    const char *nl = (const char*)memchr(p, '\n', (size_t)(end - p));
+    return nl ? nl : end;
+}
+
+/* True if [p, end) holds only whitespace */
+static int csv_blank(const char *p, const char *end) {
+    for (; p < end; p++) {
+        if (*p != ' ' && *p != '\t' && *p != '\r') return 0;
+    }
+    return 1;
+}
+
+/* Value of the field [p, end); an empty field reads as 0.0 */
+static int csv_field_value(const char *p, const char *end, double *value) {
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    if (p == end) {
+        *value = 0.0;
+        return 0;
+    }
+    
+    p = pca_parse_double(p, end, value);
+    if (!p) return -1;
+    
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    return (p == end) ? 0 : -1;
+}
+
+/*
+ * Skip leading blank lines in [p, end) and count the fields of the first
+ * data row, which fixes the column count. Returns the start of that row.
+ */
+static const char* csv_first_row(const char *p, const char *end, int *cols) {
+    while (p < end) {
+        const char *le = csv_line_end(p, end);
+        if (!csv_blank(p, le)) break;
+        p = (le < end) ? le + 1 : end;
+    }
+    
+    *cols = 0;
+    if (p < end) {
+        const char *le = csv_line_end(p, end);
+        *cols = 1;
+        for (const char *c = p; (c = (const char*)memchr(c, ',', (size_t)(le - c))) != NULL; c++) {
+            (*cols)++;
+        }
+    }
+    return p;
+}
+
+/* Smallest byte range worth handing to its own parsing thread */
+#define CSV_MIN_CHUNK_BYTES (1 << 20)
+
+/* Number of non-blank lines in [p, end) */
+static size_t csv_count_rows(const char *p, const char *end) {
+    size_t rows = 0;
+    while (p < end) {
+        const char *le = csv_line_end(p, end);
+        if (!csv_blank(p, le)) rows++;
+        p = (le < end) ? le + 1 : end;
+    }
+    return rows;
+}
+
+/* Parse failures (CsvChunkTask status) */
+#define CSV_BAD_NUMBER (-1)
+#define CSV_BAD_FIELD_COUNT (-2)
+
+/*
+ * One byte range of the input. Ranges start right after a newline, so
+ * every line belongs to exactly one chunk; row0 is the chunk's first
+ * row in the matrix, from a prefix sum over the per-chunk row counts.
+ */
+typedef struct {
+    const char *begin;
+    const char *end;            /* After parsing: start of the first unparsed line */
+    int cols;
+    size_t rows;                /* Rows to parse; after parsing, rows parsed */
+    size_t row0;                /* First matrix row of the chunk */
+    double *values;             /* Matrix buffer */
+    int status;                 /* 0, or a CSV_BAD_* code */
+    size_t bad_row;             /* Chunk-relative row of the bad field */
+    int bad_col;
+    const char *bad_field;
+} CsvChunkTask;
+
+static void csv_count_task(void *arg) {
+    CsvChunkTask *t = (CsvChunkTask*)arg;
+    t->rows = csv_count_rows(t->begin, t->end);
+}
+
+/*
+ * Parse up to t->rows non-blank lines of [begin, end) into consecutive
+ * rows from row0. On a malformed field the status is CSV_BAD_NUMBER, and
+ * on a row with more or fewer than cols fields CSV_BAD_FIELD_COUNT, with
+ * the chunk-relative row, the column and the byte position in bad_row,
+ * bad_col and bad_field (for a short row, the column and end of the
+ * missing field).
+ */
+static void csv_parse_task(void *arg) {
+    CsvChunkTask *t = (CsvChunkTask*)arg;
+    const int cols = t->cols;
+    const char *p = t->begin;
+    const char *end = t->end;
+    double *row = t->values + t->row0 * cols;
+    size_t r = 0;
+    
+    t->status = 0;
+    while (p < end && r < t->rows) {
+        const char *le = csv_line_end(p, end);
+        const char *next = (le < end) ? le + 1 : end;
+        
+        /* Skip blank lines */
+        if (csv_blank(p, le)) {
+            p = next;
+            continue;
+        }
+        
+        const char *line_end = le;
+        if (line_end > p && line_end[-1] == '\r') line_end--;
+        
+        int col = 0;
+        const char *field = p;
+        for (;;) {
+            const char *comma = (const char*)memchr(field, ',', (size_t)(line_end - field));
+            const char *field_end = comma ? comma : line_end;
+            int status = 0;
+            if (col == cols) {
+                status = CSV_BAD_FIELD_COUNT;
+            } else if (csv_field_value(field, field_end, &row[col]) != 0) {
+                status = CSV_BAD_NUMBER;
+            }
+            if (status != 0) {
+                t->status = status;
+                t->bad_row = r;
+                t->bad_col = col;
+                t->bad_field = field;
+                return;
+            }
+            col++;
+            if (!comma) break;
+            field = comma + 1;
+        }
+        if (col < cols) {
+            t->status = CSV_BAD_FIELD_COUNT;
+            t->bad_row = r;
+            t->bad_col = col;
+            t->bad_field = line_end;
+            return;
+        }
+        row += cols;
+        r++;
+        p = next;
+    }
+    t->rows = r;
+    t->end = p;
+}
+
+/*
+ * Report the first failed task in file order. base (the start of the
+ * file) and first_row (rows before the first task) position the message.
+ * Returns -1 if a task failed, 0 otherwise.
+ */
+static int csv_check_tasks(const CsvChunkTask *tasks, int n_tasks, const char *base,
+                           size_t first_row) {
+    for (int t = 0; t < n_tasks; t++) {
+        if (tasks[t].status == 0) continue;
+        
+        char message[192];
+        size_t row = first_row + tasks[t].row0 + tasks[t].bad_row + 1;
+        size_t offset = (size_t)(tasks[t].bad_field - base);
+        if (tasks[t].status == CSV_BAD_FIELD_COUNT) {
+            snprintf(message, sizeof(message),
+                     "Expected %d fields at row %zu, column %d (byte offset %zu)",
+                     tasks[t].cols, row, tasks[t].bad_col + 1, offset);
+        } else {
+            snprintf(message, sizeof(message),
+                     "Invalid number at row %zu, column %d (byte offset %zu)",
+                     row, tasks[t].bad_col + 1, offset);
+        }
+        print_error(message);
+        return -1;
+    }
+    return 0;
+}
+
+Matrix* read_csv(const char *filename) {
+    return read_csv_parallel(filename, 0);
+}
+
+/*
+ * Parse the lines of [p, end) with up to n_threads threads into a new
+ * aligned buffer of *rows x cols values (NULL when there are no rows).
+ * base is the start of the file, for error offsets.
+ */
+static int csv_parse_range(const char *base, const char *p, const char *end, int cols,
+                           int n_threads, double **values, size_t *rows) {
+    *values = NULL;
+    *rows = 0;
+    
+    /* Split the bytes evenly, then move each cut past the next newline */
+    size_t bytes = (size_t)(end - p);
+    n_threads = resolve_thread_count(n_threads);
+    size_t max_chunks = bytes / CSV_MIN_CHUNK_BYTES;
+    if ((size_t)n_threads > max_chunks) n_threads = (max_chunks > 0) ? (int)max_chunks : 1;
+    
+    CsvChunkTask *tasks = (CsvChunkTask*)calloc(n_threads, sizeof(CsvChunkTask));
+    if (!tasks) {
+        print_error("Failed to allocate CSV chunks");
+        return -1;
+    }
+    
+    const char *cut = p;
+    for (int t = 0; t < n_threads; t++) {
+        tasks[t].begin = cut;
+        if (t == n_threads - 1) {
+            cut = end;
+        } else {
+            const char *target = p + bytes / n_threads * (t + 1);
+            if (target < cut) target = cut;
+            cut = csv_line_end(target, end);
+            if (cut < end) cut++;
+        }
+        tasks[t].end = cut;
+        tasks[t].cols = cols;
+    }
+    
+    /* Count rows per chunk, then assign each chunk its row slots */
+    parallel_run(n_threads, csv_count_task, tasks, sizeof(CsvChunkTask));
+    
+    size_t total_rows = 0;
+    for (int t = 0; t < n_threads; t++) {
+        tasks[t].row0 = total_rows;
+        total_rows += tasks[t].rows;
+    }
+    
+    if (total_rows == 0) {
+        free(tasks);
+        return 0;
+    }
+    
+    /* Matrix rows are int, and the buffer size must not wrap */
+    if (total_rows > INT_MAX ||
+        total_rows > SIZE_MAX / sizeof(double) / (size_t)cols) {
+        print_error("CSV file has too many rows");
+        free(tasks);
+        return -1;
+    }
+    
+    double *buffer = aligned_doubles(total_rows * cols);
+    if (!buffer) {
+        print_error("Failed to allocate matrix buffer");
+        free(tasks);
+        return -1;
+    }
+    
+    /* Parse every chunk straight into its rows of the contiguous buffer */
+    for (int t = 0; t < n_threads; t++) {
+        tasks[t].values = buffer;
+    }
+    parallel_run(n_threads, csv_parse_task, tasks, sizeof(CsvChunkTask));
+    
+    /* Report the first malformed field in file order */
+    if (csv_check_tasks(tasks, n_threads, base, 0) != 0) {
+        free(buffer);
+        free(tasks);
+        return -1;
+    }
+    
+    free(tasks);
+    *values = buffer;
+    *rows = total_rows;
+    return 0;
+}
+
+Matrix* read_csv_parallel(const char *filename, int n_threads) {
+    print_progress("Reading CSV file...");
+    
+    FileSource src;
+    if (file_source_open(filename, &src, 0) != 0) return NULL;
+    
+    int cols;
+    const char *end = src.data + src.size;
+    const char *p = csv_first_row(src.data, end, &cols);
+    
+    double *values = NULL;
+    size_t total_rows = 0;
+    int status = (cols > 0)
+        ? csv_parse_range(src.data, p, end, cols, n_threads, &values, &total_rows) : 0;
+    file_source_close(&src);
+    if (status != 0) return NULL;
+    
+    if (total_rows == 0) {
+        print_error("CSV file contains no data");
+        return NULL;
+    }
+    
+    int rows = (int)total_rows;
+    printf("  Detected %d rows x %d columns\n", rows, cols);
+    
+    Matrix *mat = matrix_wrap(values, rows, cols, cols);
+    if (!mat) return NULL;
+    
+    print_progress("CSV file loaded successfully");
+    
+    return mat;
+}
+
+int get_csv_dimensions(const char *filename, int *rows, int *cols) {
+    FileSource src;
+    if (file_source_open(filename, &src, 0) != 0) return -1;
+    
+    const char *end = src.data + src.size;
+    const char *p = csv_first_row(src.data, end, cols);
+    size_t count = csv_count_rows(p, end);
+    
+    file_source_close(&src);
+    if (count > INT_MAX) {
+        print_error("CSV file has too many rows");
+        return -1;
+    }
+    *rows = (int)count;
+    return 0;
+}
+
+/*
+ * Chunked CSV reader for out-of-core passes. The file stays mapped, but
+ * only one chunk of parsed rows is resident at a time (in one buffer
+ * reused for every chunk), and the mapped pages behind consumed chunks
+ * are dropped with MADV_DONTNEED so the page cache does not pin the
+ * whole file to this process.
+ *
+ * Chunk ends are found while parsing, so the text is walked once. When
+ * the previous chunk was big enough to split across threads, a memchr
+ * line walk first cuts the chunk into per-thread row ranges of known
+ * size, which the threads then parse concurrently.
+ */
+struct PCAChunkReader {
+    FileSource src;
+    const char *first;          /* First data row */
+    const char *next;           /* Start of the first unread line */
+    const char *released;       /* Mapped bytes before this were dropped */
+    int cols;
+    int chunk_rows;
+    int n_threads;
+    size_t chunk_bytes;         /* Text size of the last chunk (thread count estimate) */
+    size_t rows_read;
+    Matrix *chunk;              /* Chunk buffer, chunk_rows x cols */
+    CsvChunkTask *tasks;        /* One per thread */
+};
+
+PCAChunkReader* pca_chunk_reader_open(const char *filename, int chunk_rows, int n_threads) {
+    if (!filename || chunk_rows <= 0) return NULL;
+    
+    PCAChunkReader *reader = (PCAChunkReader*)calloc(1, sizeof(PCAChunkReader));
+    if (!reader) {
+        print_error("Failed to allocate chunk reader");
+        return NULL;
+    }
+    
+    /* A heap copy would hold the whole input, which is what streaming avoids */
+    if (file_source_open(filename, &reader->src, SOURCE_MAPPED_ONLY) != 0) {
+        free(reader);
+        return NULL;
+    }
+    
+    const char *end = reader->src.data + reader->src.size;
+    reader->first = csv_first_row(reader->src.data, end, &reader->cols);
+    if (reader->cols == 0) {
+        print_error("CSV file contains no data");
+        pca_chunk_reader_close(reader);
+        return NULL;
+    }
+    
+    reader->next = reader->first;
+    reader->released = reader->src.data;
+    reader->chunk_rows = chunk_rows;
+    reader->n_threads = resolve_thread_count(n_threads);
+    reader->chunk_bytes = (size_t)(csv_line_end(reader->first, end) - reader->first + 1) *
+                          (size_t)chunk_rows;
+    
+    double *values = aligned_doubles((size_t)chunk_rows * reader->cols);
+    reader->chunk = values ? matrix_wrap(values, chunk_rows, reader->cols, reader->cols) : NULL;
+    reader->tasks = (CsvChunkTask*)calloc(reader->n_threads, sizeof(CsvChunkTask));
+    if (!reader->chunk || !reader->tasks) {
+        if (!reader->chunk) free(values);
+        print_error("Failed to allocate chunk buffer");
+        pca_chunk_reader_close(reader);
+        return NULL;
+    }
+    
+    return reader;
+}
+
+int pca_chunk_reader_cols(const PCAChunkReader *reader) {
+    return reader ? reader->cols : 0;
+}
+
+int pca_chunk_reader_next(PCAChunkReader *reader, Matrix **chunk) {
+    if (!reader || !chunk) return -1;
+    
+    *chunk = NULL;
+    const char *end = reader->src.data + reader->src.size;
+    const char *p = reader->next;
+    if (p >= end) return 0;
+    
+    /* Threads only pay off with CSV_MIN_CHUNK_BYTES each (judged by the last chunk) */
+    CsvChunkTask *tasks = reader->tasks;
+    size_t max_threads = reader->chunk_bytes / CSV_MIN_CHUNK_BYTES;
+    int n_threads = reader->n_threads;
+    if ((size_t)n_threads > max_threads) n_threads = (max_threads > 0) ? (int)max_threads : 1;
+    
+    if (n_threads == 1) {
+        /* The parser stops after chunk_rows rows and reports where */
+        tasks[0].begin = p;
+        tasks[0].end = end;
+        tasks[0].rows = (size_t)reader->chunk_rows;
+    } else {
+        /* Cut the chunk into per-thread row ranges in one line walk */
+        size_t per_thread = ((size_t)reader->chunk_rows + n_threads - 1) / n_threads;
+        int t = 0;
+        size_t rows = 0;
+        size_t total = 0;
+        tasks[0].begin = p;
+        while (p < end && total < (size_t)reader->chunk_rows) {
+            const char *le = csv_line_end(p, end);
+            if (!csv_blank(p, le)) {
+                rows++;
+                total++;
+            }
+            p = (le < end) ? le + 1 : end;
+            if (rows == per_thread && t < n_threads - 1) {
+                tasks[t].end = p;
+                tasks[t].rows = rows;
+                tasks[++t].begin = p;
+                rows = 0;
+            }
+        }
+        tasks[t].end = p;
+        tasks[t].rows = rows;
+        n_threads = t + 1;
+    }
+    
+    size_t row0 = 0;
+    for (int t = 0; t < n_threads; t++) {
+        tasks[t].cols = reader->cols;
+        tasks[t].values = reader->chunk->values;
+        tasks[t].row0 = row0;
+        row0 += tasks[t].rows;
+    }
+    parallel_run(n_threads, csv_parse_task, tasks, sizeof(CsvChunkTask));
+    if (csv_check_tasks(tasks, n_threads, reader->src.data, reader->rows_read) != 0) {
+        return -1;
+    }
+    
+    size_t parsed = 0;
+    for (int t = 0; t < n_threads; t++) {
+        parsed += tasks[t].rows;
+    }
+    p = tasks[n_threads - 1].end;
+    reader->chunk_bytes = (size_t)(p - reader->next);
+    reader->next = p;
+    if (parsed == 0) return 0;
+    
+    reader->rows_read += parsed;
+    reader->chunk->rows = (int)parsed;
+    
+    /* Drop the whole pages the parsed text occupied */
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    const char *cut = reader->src.data + (size_t)(p - reader->src.data) / page * page;
+    if (cut > reader->released) {
+        madvise((void*)reader->released, (size_t)(cut - reader->released), MADV_DONTNEED);
+        reader->released = cut;
+    }
+    
+    *chunk = reader->chunk;
+    return 1;
+}
+
+void pca_chunk_reader_rewind(PCAChunkReader *reader) {
+    if (!reader) return;
+    
+    reader->next = reader->first;
+    reader->released = reader->src.data;
+    reader->rows_read = 0;
+}
+
+size_t pca_chunk_reader_rows(const PCAChunkReader *reader) {
+    return reader ? reader->rows_read : 0;
+}
+
+void pca_chunk_reader_close(PCAChunkReader *reader) {
+    if (!reader) return;
+    
+    matrix_free(reader->chunk);
+    free(reader->tasks);
+    file_source_close(&reader->src);
+    free(reader);
+}
+
+/*
+ * CSV output is produced in rounds: each thread formats a block of about
+ * CSV_WRITE_BUFFER_BYTES of rows into its own buffer, then the blocks are
+ * written in row order with a single pwritev at the running file offset
+ * (writev when the output is not seekable, e.g. a pipe).
+ */
+#define CSV_WRITE_BUFFER_BYTES (1 << 20)
+#define CSV_BYTES_PER_VALUE 24  /* Typical formatted value plus separator */
+
+typedef struct {
+    const Matrix *mat;
+    int r0;                     /* Rows [r0, r1) of this block */
+    int r1;
+    int precision;
+    char *buffer;               /* Grows as needed, kept across rounds */
+    size_t capacity;
+    size_t used;
+    int status;                 /* 0, or -1 if the buffer could not grow */
+} CsvFormatTask;
+
+static void csv_format_task(void *arg) {
+    CsvFormatTask *t = (CsvFormatTask*)arg;
+    int cols = t->mat->cols;
+    
+    t->used = 0;
+    t->status = 0;
+    for (int i = t->r0; i < t->r1; i++) {
+        const double *row = MATRIX_ROW(t->mat, i);
+        for (int j = 0; j < cols; j++) {
+            if (t->capacity - t->used < PCA_FORMAT_MAX_CHARS + 1) {
+                size_t capacity = t->capacity * 2 + PCA_FORMAT_MAX_CHARS + 1;
+                char *grown = (char*)realloc(t->buffer, capacity);
+                if (!grown) {
+                    t->status = -1;
+                    return;
+                }
+                t->buffer = grown;
+                t->capacity = capacity;
+            }
+            t->used += pca_format_double(row[j], t->precision, t->buffer + t->used);
+            t->buffer[t->used++] = (j < cols - 1) ? ',' : '\n';
+        }
+    }
+}
+
+/*
+ * Write all count blocks in order, at *offset with pwritev (advancing it)
+ * or at the current position with writev when offset is NULL. Short
+ * writes resume where they stopped.
+ */
+static int write_blocks(int fd, struct iovec *iov, int count, off_t *offset) {
+    while (count > 0) {
+        ssize_t n = offset ? pwritev(fd, iov, count, *offset) : writev(fd, iov, count);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (offset) *offset += n;
+        
+        /* Drop fully written blocks and trim a partially written one */
+        while (count > 0 && (size_t)n >= iov->iov_len) {
+            n -= (ssize_t)iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = (char*)iov->iov_base + n;
+            iov->iov_len -= (size_t)n;
+        }
+    }
+    return 0;
+}
+
+int write_csv(const Matrix *mat, const char *filename) {
+    return write_csv_parallel(mat, filename, -1, 0);
+}
+
+int write_csv_precision(const Matrix *mat, const char *filename, int precision) {
+    return write_csv_parallel(mat, filename, precision, 0);
+}
+
+/*
+ * Format and write the rows of mat to fd in rounds. position is the file
+ * offset for pwritev (advanced past the rows), or NULL to writev at the
+ * current position.
+ */
+static int csv_write_rows(int fd, off_t *position, const Matrix *mat, int precision,
+                          int n_threads) {
+    n_threads = row_thread_count(n_threads, mat->rows);
+    int block_rows = CSV_WRITE_BUFFER_BYTES / ((size_t)mat->cols * CSV_BYTES_PER_VALUE);
+    if (block_rows < 1) block_rows = 1;
+    
+    CsvFormatTask *tasks = (CsvFormatTask*)calloc(n_threads, sizeof(CsvFormatTask));
+    struct iovec *iov = (struct iovec*)malloc(n_threads * sizeof(struct iovec));
+    if (!tasks || !iov) {
+        print_error("Failed to allocate CSV write buffers");
+        free(tasks);
+        free(iov);
+        return -1;
+    }
+    for (int t = 0; t < n_threads; t++) {
+        tasks[t].mat = mat;
+        tasks[t].precision = precision;
+    }
+    
+    int ok = 1;
+    for (int r = 0; ok && r < mat->rows; ) {
+        int active = 0;
+        while (active < n_threads && r < mat->rows) {
+            tasks[active].r0 = r;
+            r = (mat->rows - r > block_rows) ? r + block_rows : mat->rows;
+            tasks[active].r1 = r;
+            active++;
+        }
+        
+        parallel_run(active, csv_format_task, tasks, sizeof(CsvFormatTask));
+        
+        for (int t = 0; t < active; t++) {
+            if (tasks[t].status != 0) ok = 0;
+            iov[t].iov_base = tasks[t].buffer;
+            iov[t].iov_len = tasks[t].used;
+        }
+        if (ok && write_blocks(fd, iov, active, position) != 0) ok = 0;
+    }
+    
+    for (int t = 0; t < n_threads; t++) {
+        free(tasks[t].buffer);
+    }
+    free(tasks);
+    free(iov);
+    return ok ? 0 : -1;
+}
+
+/* Open filename for CSV output; *position is set to NULL if it is not seekable */
+static int csv_output_open(const char *filename, off_t *offset, off_t **position) {
+    int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        print_error("Failed to open file for writing");
+        return -1;
+    }
+    
+    /* pwritev needs a seekable file; pipes and terminals get writev */
+    *offset = 0;
+    *position = (lseek(fd, 0, SEEK_CUR) >= 0) ? offset : NULL;
+    return fd;
+}
+
+int write_csv_parallel(const Matrix *mat, const char *filename, int precision, int n_threads) {
+    if (!mat || !filename) return -1;
+    
+    print_progress("Writing results to CSV...");
+    
+    off_t offset, *position;
+    int fd = csv_output_open(filename, &offset, &position);
+    if (fd < 0) return -1;
+    
+    int ok = (csv_write_rows(fd, position, mat, precision, n_threads) == 0);
+    if (close(fd) != 0) ok = 0;
+    if (!ok) {
+        print_error("Failed to write CSV file");
+        return -1;
+    }
+    
+    printf("  Wrote %d rows x %d columns to %s\n", mat->rows, mat->cols, filename);
+    
+    return 0;
+}
+
+/*
+ * Binary matrix container: a 64-byte header followed by the elements.
+ * The payload offset is a multiple of MATRIX_ALIGNMENT, so a float64
+ * row-major payload in a page-aligned mapping is already a valid matrix
+ * buffer and is used in place.
+ */
+#define BINARY_MATRIX_MAGIC "PCAMATRX"
+#define BINARY_MATRIX_VERSION 1
+#define BINARY_MATRIX_BYTE_ORDER 0x01020304u
+#define BINARY_MATRIX_HEADER_SIZE 64
+
+typedef struct {
+    char magic[8];              /* BINARY_MATRIX_MAGIC */
+    uint32_t version;           /* BINARY_MATRIX_VERSION */
+    uint32_t byte_order;        /* BINARY_MATRIX_BYTE_ORDER as written */
+    uint32_t dtype;             /* PCA_DTYPE_FLOAT64 or PCA_DTYPE_FLOAT32 */
+    uint32_t layout;            /* PCA_LAYOUT_ROW_MAJOR or PCA_LAYOUT_COL_MAJOR */
+    uint64_t rows;
+    uint64_t cols;
+    uint64_t data_offset;       /* Payload start, from the start of the file */
+    unsigned char reserved[16]; /* Zero */
+} BinaryMatrixHeader;
+
+/* Element idx of a float64 or float32 payload (which may be unaligned) */
+static double binary_element(const unsigned char *payload, uint32_t dtype, size_t idx) {
+    if (dtype == PCA_DTYPE_FLOAT64) {
+        double v;
+        memcpy(&v, payload + idx * sizeof(double), sizeof(double));
+        return v;
+    }
+    float f;
+    memcpy(&f, payload + idx * sizeof(float), sizeof(float));
+    return (double)f;
+}
+
+/*
+ * Wrap values that live inside a file mapping; the mapping is unmapped
+ * by matrix_free (or here, on failure).
+ */
+static Matrix* matrix_wrap_mapping(void *mapping, size_t mapping_size, double *values,
+                                   int rows, int cols) {
+    Matrix *mat = (Matrix*)malloc(sizeof(Matrix));
+    double **row_view = (double**)malloc(rows * sizeof(double*));
+    if (!mat || !row_view) {
+        print_error("Failed to allocate matrix structure");
+        free(mat);
+        free(row_view);
+        munmap(mapping, mapping_size);
+        return NULL;
+    }
+    
+    mat->values = values;
+    mat->data = row_view;
+    mat->rows = rows;
+    mat->cols = cols;
+    mat->stride = cols;
+    mat->borrowed = 0;
+    mat->mapping = mapping;
+    mat->mapping_size = mapping_size;
+    for (int i = 0; i < rows; i++) {
+        mat->data[i] = MATRIX_ROW(mat, i);
+    }
+    
+    return mat;
+}
+
+/*
+ * Build a matrix from the payload at offset in src, then close src. A
+ * float64 row-major payload that is MATRIX_ALIGNMENT-aligned inside a
+ * mapping becomes the matrix buffer (the matrix takes over the mapping);
+ * anything else is converted into a fresh row-major float64 buffer.
+ */
+static Matrix* matrix_from_payload(FileSource *src, size_t offset, uint32_t dtype,
+                                   uint32_t layout, int rows, int cols) {
+    const unsigned char *payload = (const unsigned char*)src->data + offset;
+    
+    if (src->mapping && dtype == PCA_DTYPE_FLOAT64 && layout == PCA_LAYOUT_ROW_MAJOR &&
+        (uintptr_t)payload % MATRIX_ALIGNMENT == 0) {
+        Matrix *mat = matrix_wrap_mapping(src->mapping, src->size, (double*)payload, rows, cols);
+        memset(src, 0, sizeof(*src));
+        if (!mat) return NULL;
+        print_progress("Matrix mapped without copying");
+        return mat;
+    }
+    
+    double *values = aligned_doubles((size_t)rows * cols);
+    if (!values) {
+        print_error("Failed to allocate matrix buffer");
+        file_source_close(src);
+        return NULL;
+    }
+    
+    int col_major = (layout == PCA_LAYOUT_COL_MAJOR);
+    int outer = col_major ? cols : rows;
+    int inner = col_major ? rows : cols;
+    size_t idx = 0;
+    for (int a = 0; a < outer; a++) {
+        for (int b = 0; b < inner; b++) {
+            double v = binary_element(payload, dtype, idx++);
+            if (col_major) {
+                values[(size_t)b * cols + a] = v;
+            } else {
+                values[(size_t)a * cols + b] = v;
+            }
+        }
+    }
+    file_source_close(src);
+    
+    Matrix *mat = matrix_wrap(values, rows, cols, cols);
+    if (!mat) return NULL;
+    
+    print_progress("Matrix loaded successfully");
+    
+    return mat;
+}
+
+/* Write the rows of mat as packed float64; one write when already packed */
+static int write_matrix_payload(const Matrix *mat, FILE *file) {
+    if (mat->stride == mat->cols) {
+        size_t count = (size_t)mat->rows * mat->cols;
+        return (fwrite(mat->values, sizeof(double), count, file) == count) ? 0 : -1;
+    }
+    for (int i = 0; i < mat->rows; i++) {
+        if (fwrite(MATRIX_ROW(mat, i), sizeof(double), mat->cols, file) != (size_t)mat->cols) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+Matrix* read_matrix_binary(const char *filename) {
+    print_progress("Reading binary matrix...");
+    
+    FileSource src;
+    if (file_source_open(filename, &src, SOURCE_WRITABLE) != 0) return NULL;
+    
+    BinaryMatrixHeader header;
+    if (src.size < sizeof(header)) {
+        print_error("File is too small for a binary matrix header");
+        file_source_close(&src);
+        return NULL;
+    }
+    memcpy(&header, src.data, sizeof(header));
+    
+    if (memcmp(header.magic, BINARY_MATRIX_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != BINARY_MATRIX_VERSION) {
+        print_error("Not a binary matrix file (bad magic or version)");
+        file_source_close(&src);
+        return NULL;
+    }
+    if (header.byte_order != BINARY_MATRIX_BYTE_ORDER) {
+        print_error("Binary matrix byte order does not match this machine");
+        file_source_close(&src);
+        return NULL;
+    }
+    if ((header.dtype != PCA_DTYPE_FLOAT64 && header.dtype != PCA_DTYPE_FLOAT32) ||
+        (header.layout != PCA_LAYOUT_ROW_MAJOR && header.layout != PCA_LAYOUT_COL_MAJOR)) {
+        print_error("Unsupported binary matrix dtype or layout");
+        file_source_close(&src);
+        return NULL;
+    }
+    
+    size_t elem = (header.dtype == PCA_DTYPE_FLOAT64) ? sizeof(double) : sizeof(float);
+    if (header.rows == 0 || header.cols == 0 ||
+        header.rows > 2147483647ULL || header.cols > 2147483647ULL ||
+        header.data_offset < sizeof(header) || header.data_offset > src.size ||
+        header.rows > (src.size - header.data_offset) / elem / header.cols) {
+        print_error("Binary matrix header does not match the file size");
+        file_source_close(&src);
+        return NULL;
+    }
+    
+    int rows = (int)header.rows;
+    int cols = (int)header.cols;
+    printf("  Detected %d rows x %d columns (%s, %s-major)\n", rows, cols,
+           header.dtype == PCA_DTYPE_FLOAT64 ? "float64" : "float32",
+           header.layout == PCA_LAYOUT_ROW_MAJOR ? "row" : "column");
+    
+    return matrix_from_payload(&src, (size_t)header.data_offset, header.dtype,
+                               header.layout, rows, cols);
+}
+
+int write_matrix_binary(const Matrix *mat, const char *filename) {
+    if (!mat || !filename) return -1;
+    
+    print_progress("Writing results to binary matrix...");
+    
+    FILE *file = fopen(filename, "wb");
+    if (!file) {
+        print_error("Failed to open file for writing");
+        return -1;
+    }
+    
+    BinaryMatrixHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BINARY_MATRIX_MAGIC, sizeof(header.magic));
+    header.version = BINARY_MATRIX_VERSION;
+    header.byte_order = BINARY_MATRIX_BYTE_ORDER;
+    header.dtype = PCA_DTYPE_FLOAT64;
+    header.layout = PCA_LAYOUT_ROW_MAJOR;
+    header.rows = (uint64_t)mat->rows;
+    header.cols = (uint64_t)mat->cols;
+    header.data_offset = BINARY_MATRIX_HEADER_SIZE;
+    
+    int ok = (fwrite(&header, sizeof(header), 1, file) == 1) &&
+             (write_matrix_payload(mat, file) == 0);
+    if (fclose(file) != 0) ok = 0;
+    if (!ok) {
+        print_error("Failed to write binary matrix");
+        return -1;
+    }
+    
+    printf("  Wrote %d rows x %d columns to %s\n", mat->rows, mat->cols, filename);
+    
+    return 0;
+}
+
+/*
+ * NumPy .npy files: the magic "\x93NUMPY", a version, the length of a
+ * Python dict literal describing the array, the dict itself (padded so
+ * the payload starts on a 64-byte boundary) and the raw elements.
+ */
+#define NPY_MAGIC "\x93NUMPY"
+#define NPY_MAGIC_SIZE 6
+#define NPY_ALIGNMENT 64
+
+static int host_is_little_endian(void) {
+    uint32_t probe = 1;
+    return *(const unsigned char*)&probe == 1;
+}
+
+/* Start of the value for 'key' in the header dict, NULL if absent */
+static const char* npy_header_value(const char *header, const char *key) {
+    const char *p = strstr(header, key);
+    if (!p) return NULL;
+    p = strchr(p + strlen(key), ':');
+    if (!p) return NULL;
+    for (p++; *p == ' '; p++) {}
+    return p;
+}
+
+/* Parse the descr, fortran_order and shape entries of an .npy header */
+static int npy_parse_header(const char *header, uint32_t *dtype, uint32_t *layout,
+                            long long *rows, long long *cols) {
+    const char *descr = npy_header_value(header, "'descr'");
+    if (!descr || (*descr != '\'' && *descr != '"')) return -1;
+    char quote = *descr++;
+    const char *descr_end = strchr(descr, quote);
+    if (!descr_end || descr_end - descr != 3) return -1;
+    
+    /* '<' little-endian, '>' big-endian, '=' native */
+    char order = descr[0];
+    int native = (order == '=') || (order == '<' && host_is_little_endian()) ||
+                 (order == '>' && !host_is_little_endian());
+    if (!native || descr[1] != 'f') return -1;
+    if (descr[2] == '8') {
+        *dtype = PCA_DTYPE_FLOAT64;
+    } else if (descr[2] == '4') {
+        *dtype = PCA_DTYPE_FLOAT32;
+    } else {
+        return -1;
+    }
+    
+    const char *fortran = npy_header_value(header, "'fortran_order'");
+    if (!fortran) return -1;
+    if (strncmp(fortran, "True", 4) == 0) {
+        *layout = PCA_LAYOUT_COL_MAJOR;
+    } else if (strncmp(fortran, "False", 5) == 0) {
+        *layout = PCA_LAYOUT_ROW_MAJOR;
+    } else {
+        return -1;
+    }
+    
+    /* (n,) is read as one column, (n, d) as n x d */
+    const char *shape = npy_header_value(header, "'shape'");
+    if (!shape || *shape != '(') return -1;
+    const char *shape_end = strchr(shape, ')');
+    if (!shape_end) return -1;
+    
+    double dims[2];
+    int n_dims = 0;
+    const char *p = shape + 1;
+    while (p < shape_end) {
+        while (p < shape_end && (*p == ' ' || *p == ',')) p++;
+        if (p == shape_end) break;
+        if (n_dims == 2) return -1;
+        p = pca_parse_double(p, shape_end, &dims[n_dims]);
+        if (!p || dims[n_dims] != floor(dims[n_dims])) return -1;
+        n_dims++;
+    }
+    if (n_dims == 0) return -1;
+    
+    *rows = (long long)dims[0];
+    *cols = (n_dims == 2) ? (long long)dims[1] : 1;
+    return 0;
+}
+
+Matrix* read_npy(const char *filename) {
+    print_progress("Reading .npy file...");
+    
+    FileSource src;
+    if (file_source_open(filename, &src, SOURCE_WRITABLE) != 0) return NULL;
+    
+    /* Version 1 stores the header length in 2 bytes, versions 2 and 3 in 4 */
+    const unsigned char *bytes = (const unsigned char*)src.data;
+    if (src.size < NPY_MAGIC_SIZE + 4 || memcmp(bytes, NPY_MAGIC, NPY_MAGIC_SIZE) != 0 ||
+        bytes[6] < 1 || bytes[6] > 3) {
+        print_error("Not a .npy file (bad magic or version)");
+        file_source_close(&src);
+        return NULL;
+    }
+    
+    size_t prefix = (bytes[6] == 1) ? 10 : 12;
+    size_t header_len = 0;
+    if (src.size >= prefix) {
+        header_len = (size_t)bytes[8] | ((size_t)bytes[9] << 8);
+        if (bytes[6] > 1) {
+            header_len |= ((size_t)bytes[10] << 16) | ((size_t)bytes[11] << 24);
+        }
+    }
+    if (src.size < prefix || header_len > src.size - prefix) {
+        print_error("Truncated .npy header");
+        file_source_close(&src);
+        return NULL;
+    }
+    
+    char *header = (char*)malloc(header_len + 1);
+    if (!header) {
+        print_error("Failed to allocate .npy header");
+        file_source_close(&src);
+        return NULL;
+    }
+    memcpy(header, src.data + prefix, header_len);
+    header[header_len] = '\0';
+    
+    uint32_t dtype, layout;
+    long long rows, cols;
+    int status = npy_parse_header(header, &dtype, &layout, &rows, &cols);
+    free(header);
+    if (status != 0) {
+        print_error("Unsupported .npy array (need native float32/float64, 1-D or 2-D)");
+        file_source_close(&src);
+        return NULL;
+    }
+    
+    size_t offset = prefix + header_len;
+    size_t elem = (dtype == PCA_DTYPE_FLOAT64) ? sizeof(double) : sizeof(float);
+    if (rows <= 0 || cols <= 0 || rows > 2147483647LL || cols > 2147483647LL ||
+        (size_t)rows > (src.size - offset) / elem / (size_t)cols) {
+        print_error(".npy shape does not match the file size");
+        file_source_close(&src);
+        return NULL;
+    }
+    
+    printf("  Detected %lld rows x %lld columns (%s, %s order)\n", rows, cols,
+           dtype == PCA_DTYPE_FLOAT64 ? "float64" : "float32",
+           layout == PCA_LAYOUT_ROW_MAJOR ? "C" : "Fortran");
+    
+    return matrix_from_payload(&src, offset, dtype, layout, (int)rows, (int)cols);
+}
+
+int write_npy(const Matrix *mat, const char *filename) {
+    if (!mat || !filename) return -1;
+    
+    print_progress("Writing results to .npy...");
+    
+    FILE *file = fopen(filename, "wb");
+    if (!file) {
+        print_error("Failed to open file for writing");
+        return -1;
+    }
+    
+    /* Version 1.0 header, space-padded so the payload is 64-byte aligned */
+    char header[256];
+    int len = snprintf(header, sizeof(header),
+                       "{'descr': '%cf8', 'fortran_order': False, 'shape': (%d, %d), }",
+                       host_is_little_endian() ? '<' : '>', mat->rows, mat->cols);
+    size_t total = NPY_MAGIC_SIZE + 4 + (size_t)len + 1;
+    size_t padded = (total + NPY_ALIGNMENT - 1) / NPY_ALIGNMENT * NPY_ALIGNMENT;
+    memset(header + len, ' ', padded - total);
+    len += (int)(padded - total);
+    header[len++] = '\n';
+    
+    unsigned char prefix[NPY_MAGIC_SIZE + 4];
+    memcpy(prefix, NPY_MAGIC, NPY_MAGIC_SIZE);
+    prefix[6] = 1;
+    prefix[7] = 0;
+    prefix[8] = (unsigned char)(len & 0xff);
+    prefix[9] = (unsigned char)(len >> 8);
+    
+    int ok = (fwrite(prefix, sizeof(prefix), 1, file) == 1) &&
+             (fwrite(header, 1, (size_t)len, file) == (size_t)len) &&
+             (write_matrix_payload(mat, file) == 0);
+    if (fclose(file) != 0) ok = 0;
+    if (!ok) {
+        print_error("Failed to write .npy file");
+        return -1;
+    }
+    
+    printf("  Wrote %d rows x %d columns to %s\n", mat->rows, mat->cols, filename);
+    
+    return 0;
+}
+
+/* ============================================
+ * Statistical Operations Implementation
+ * ============================================ */
+
+double* compute_mean(const Matrix *mat) {
+    if (!mat) return NULL;
+    
+    double *mean = (double*)calloc(mat->cols, sizeof(double));
+    if (!mean) {
+        print_error("Failed to allocate mean array");
+        return NULL;
+    }
+    
+    /* Sum each column, walking the buffer row by row */
+    for (int i = 0; i < mat->rows; i++) {
+        const double *row = MATRIX_ROW(mat, i);
+        for (int j = 0; j < mat->cols; j++) {
+            mean[j] += row[j];
+        }
+    }
+    for (int j = 0; j < mat->cols; j++) {
+        mean[j] /= mat->rows;
+    }
+    
+    return mean;
+}
+
+void center_data(Matrix *mat, const double *mean) {
+    if (!mat || !mean) return;
+    
+    print_progress("Centering data (subtracting mean)...");
+    
+    for (int i = 0; i < mat->rows; i++) {
+        double *row = MATRIX_ROW(mat, i);
+        for (int j = 0; j < mat->cols; j++) {
+            row[j] -= mean[j];
+        }
+    }
+}
+
+/* Per-thread state for the covariance row-block split */
+typedef struct {
+    const Matrix *mat;
+    int row_start;
+    int row_end;
+    double *partial;            /* Private d x d accumulator (upper triangle) */
+    int ld;                     /* Leading dimension of partial */
+    int status;
+} CovarianceTask;
+
+static void covariance_task(void *arg) {
+    CovarianceTask *t = (CovarianceTask*)arg;
+    const Matrix *mat = t->mat;
+    
+    t->status = gemm_driver(mat->cols, mat->cols, t->row_end - t->row_start,
+                            MATRIX_ROW(mat, t->row_start), mat->stride, 1,
+                            MATRIX_ROW(mat, t->row_start), mat->stride,
+                            t->partial, t->ld, 1, NULL);
+}
+
+Matrix* compute_covariance(const Matrix *mat) {
+    return compute_covariance_parallel(mat, 1);
+}
+
+Matrix* compute_covariance_parallel(const Matrix *mat, int n_threads) {
+    if (!mat) return NULL;
+    
+    print_progress("Computing covariance matrix...");
+    
+    int d = mat->cols;
+    n_threads = row_thread_count(n_threads, mat->rows);
+    
+    /* Covariance = (X^T * X) / (n - 1), upper triangle only, no transpose copy */
+    Matrix *cov = matrix_create(d, d);
+    if (!cov) return NULL;
+    
+    CovarianceTask *tasks = (CovarianceTask*)calloc(n_threads, sizeof(CovarianceTask));
+    if (!tasks) {
+        matrix_free(cov);
+        return NULL;
+    }
+    
+    /* Thread 0 accumulates straight into cov, the others into private partials */
+    int ok = 1;
+    for (int t = 0; t < n_threads; t++) {
+        tasks[t].mat = mat;
+        tasks[t].row_start = (int)((long long)mat->rows * t / n_threads);
+        tasks[t].row_end = (int)((long long)mat->rows * (t + 1) / n_threads);
+        tasks[t].ld = cov->stride;
+        if (t == 0) {
+            tasks[t].partial = cov->values;
+        } else {
+            tasks[t].partial = (double*)calloc((size_t)d * cov->stride, sizeof(double));
+            if (!tasks[t].partial) ok = 0;
+        }
+    }
+    
+    if (ok) {
+        parallel_run(n_threads, covariance_task, tasks, sizeof(CovarianceTask));
+        for (int t = 0; t < n_threads; t++) {
+            if (tasks[t].status != 0) ok = 0;
+        }
+    }
+    
+    /* Reduce partial upper triangles into cov */
+    for (int t = 1; t < n_threads; t++) {
+        if (ok) {
+            for (int i = 0; i < d; i++) {
+                double *cov_row = MATRIX_ROW(cov, i);
+                const double *part_row = tasks[t].partial + (size_t)i * cov->stride;
+                for (int j = i; j < d; j++) {
+                    cov_row[j] += part_row[j];
+                }
+            }
+        }
+        free(tasks[t].partial);
+    }
+    free(tasks);
+    
+    if (!ok) {
+        print_error("Failed to allocate covariance accumulators");
+        matrix_free(cov);
+        return NULL;
+    }
+    
+    symmetrize_upper(cov->values, d, cov->stride);
+    
+    /* Scale by 1 / (n - 1) */
+    double scale = 1.0 / ((mat->rows > 1) ? (mat->rows - 1) : 1);
+    size_t count = (size_t)cov->rows * cov->stride;
+    for (size_t i = 0; i < count; i++) {
+        cov->values[i] *= scale;
+    }
+    
+    printf("  Covariance matrix: %d x %d (%d thread%s)\n", cov->rows, cov->cols,
+           n_threads, (n_threads == 1) ? "" : "s");
+    
+    return cov;
+}
+
+/*
+ * Fused mean + covariance accumulator.
+ *
+ * Rows are consumed in blocks: each block is centered on its own mean in
+ * a small scratch buffer, its co-moment is accumulated with the SYRK
+ * kernel, and the block is folded into the running statistics with
+ * Chan's pairwise formula
+ *
+ *   M = M_a + M_b + delta * delta^T * n_a * n_b / n,  delta = mean_b - mean_a
+ *
+ * Centering each block before the products keeps large feature offsets
+ * out of the sums, and the same formula merges accumulators built on
+ * different threads or chunks.
+ */
+
+#define COV_BLOCK_ROWS 256
+#define COV_BLOCK_BYTES (2 * 1024 * 1024)
+
+/* Block size: as many rows as fit the scratch budget, within limits */
+static int cov_block_rows(int dim) {
+    int block_rows = (int)(COV_BLOCK_BYTES / ((size_t)dim * sizeof(double)));
+    if (block_rows > COV_BLOCK_ROWS) block_rows = COV_BLOCK_ROWS;
+    if (block_rows < 16) block_rows = 16;
+    return block_rows;
+}
+
+/* Accumulator with all buffers taken from the arena (or the heap) */
+static CovAccumulator* cov_accumulator_alloc(PCAArena *arena, int dim) {
+    if (dim <= 0) {
+        print_error("Invalid accumulator dimension");
+        return NULL;
+    }
+    
+    CovAccumulator *acc = (CovAccumulator*)scratch_calloc(arena, 1, sizeof(CovAccumulator));
+    if (!acc) {
+        print_error("Failed to allocate covariance accumulator");
+        return NULL;
+    }
+    
+    acc->dim = dim;
+    acc->count = 0;
+    acc->block_rows = cov_block_rows(dim);
+    
+    acc->mean = (double*)scratch_calloc(arena, dim, sizeof(double));
+    acc->block_mean = (double*)scratch_calloc(arena, dim, sizeof(double));
+    acc->comoment = scratch_matrix(arena, dim, dim);
+    acc->scratch = scratch_matrix(arena, acc->block_rows, dim);
+    acc->pack = (double*)scratch_alloc(arena, gemm_pack_size(dim, dim, acc->block_rows, NULL) *
+                                              sizeof(double));
+    
+    if (!acc->mean || !acc->block_mean || !acc->comoment || !acc->scratch || !acc->pack) {
+        print_error("Failed to allocate covariance accumulator");
+        if (!arena) cov_accumulator_free(acc);
+        return NULL;
+    }
+    
+    return acc;
+}
+
+CovAccumulator* cov_accumulator_create(int dim) {
+    return cov_accumulator_alloc(NULL, dim);
+}
+
+void cov_accumulator_free(CovAccumulator *acc) {
+    if (!acc) return;
+    
+    if (acc->mean) free(acc->mean);
+    if (acc->block_mean) free(acc->block_mean);
+    if (acc->comoment) matrix_free(acc->comoment);
+    if (acc->scratch) matrix_free(acc->scratch);
+    if (acc->pack) free(acc->pack);
+    free(acc);
+}
+
+/* Fold a block with n_b rows, mean block_mean and co-moment already in
+ * acc->comoment into the running mean (Chan's rank-1 correction) */
+static void cov_accumulator_fold(CovAccumulator *acc, long long n_b,
+                                 const double *mean_b) {
+    int d = acc->dim;
+    long long n_a = acc->count;
+    long long n = n_a + n_b;
+    
+    if (n_a > 0) {
+        double coef = (double)n_a * (double)n_b / (double)n;
+        for (int i = 0; i < d; i++) {
+            double delta_i = mean_b[i] - acc->mean[i];
+            double *row = MATRIX_ROW(acc->comoment, i);
+            for (int j = i; j < d; j++) {
+                row[j] += coef * delta_i * (mean_b[j] - acc->mean[j]);
+            }
+        }
+    }
+    
+    double weight = (double)n_b / (double)n;
+    for (int j = 0; j < d; j++) {
+        acc->mean[j] += (mean_b[j] - acc->mean[j]) * weight;
+    }
+    acc->count = n;
+}
+
+int cov_accumulator_update(CovAccumulator *acc, const Matrix *data,
+                           int row_start, int row_end) {
+    if (!acc || !data || data->cols != acc->dim ||
+        row_start < 0 || row_end > data->rows || row_start > row_end) {
+        print_error("Invalid accumulator update");
+        return -1;
+    }
+    
+    int d = acc->dim;
+    Matrix *scratch = acc->scratch;
+    
+    for (int r0 = row_start; r0 < row_end; r0 += acc->block_rows) {
+        int b = (row_end - r0 < acc->block_rows) ? row_end - r0 : acc->block_rows;
+        
+        /* Block mean */
+        memset(acc->block_mean, 0, d * sizeof(double));
+        for (int i = 0; i < b; i++) {
+            const double *row = MATRIX_ROW(data, r0 + i);
+            for (int j = 0; j < d; j++) {
+                acc->block_mean[j] += row[j];
+            }
+        }
+        for (int j = 0; j < d; j++) {
+            acc->block_mean[j] /= b;
+        }
+        
+        /* Center the block into scratch (the input is never modified) */
+        for (int i = 0; i < b; i++) {
+            const double *row = MATRIX_ROW(data, r0 + i);
+            double *out = MATRIX_ROW(scratch, i);
+            for (int j = 0; j < d; j++) {
+                out[j] = row[j] - acc->block_mean[j];
+            }
+        }
+        
+        /* M += Xc^T Xc (upper triangle), then Chan correction for the mean shift */
+        gemm_driver(d, d, b, scratch->values, scratch->stride, 1,
+                    scratch->values, scratch->stride,
+                    acc->comoment->values, acc->comoment->stride, 1, acc->pack);
+        cov_accumulator_fold(acc, b, acc->block_mean);
+    }
+    
+    return 0;
+}
+
+int cov_accumulator_merge(CovAccumulator *dst, const CovAccumulator *src) {
+    if (!dst || !src || dst->dim != src->dim) {
+        print_error("Invalid accumulator merge");
+        return -1;
+    }
+    if (src->count == 0) return 0;
+    
+    int d = dst->dim;
+    for (int i = 0; i < d; i++) {
+        double *dst_row = MATRIX_ROW(dst->comoment, i);
+        const double *src_row = MATRIX_ROW(src->comoment, i);
+        for (int j = i; j < d; j++) {
+            dst_row[j] += src_row[j];
+        }
+    }
+    cov_accumulator_fold(dst, src->count, src->mean);
+    
+    return 0;
+}
+
+/* Turn an upper-triangular co-moment over count rows into the covariance */
+static void comoment_to_covariance(Matrix *cov, long long count) {
+    symmetrize_upper(cov->values, cov->rows, cov->stride);
+    
+    double scale = 1.0 / ((count > 1) ? (double)(count - 1) : 1.0);
+    size_t n_values = (size_t)cov->rows * cov->stride;
+    for (size_t i = 0; i < n_values; i++) {
+        cov->values[i] *= scale;
+    }
+}
+
+Matrix* cov_accumulator_covariance(const CovAccumulator *acc) {
+    if (!acc) return NULL;
+    
+    Matrix *cov = matrix_create(acc->dim, acc->dim);
+    if (!cov) return NULL;
+    
+    matrix_copy(cov, acc->comoment);
+    comoment_to_covariance(cov, acc->count);
+    
+    return cov;
+}
+
+/* Per-thread state for the fused mean + covariance pass */
+typedef struct {
+    const Matrix *data;
+    int row_start;
+    int row_end;
+    CovAccumulator *acc;
+    int status;
+} MeanCovarianceTask;
+
+static void mean_covariance_task(void *arg) {
+    MeanCovarianceTask *t = (MeanCovarianceTask*)arg;
+    t->status = cov_accumulator_update(t->acc, t->data, t->row_start, t->row_end);
+}
+
+/*
+ * Fused mean + covariance pass writing the mean into a caller array. The
+ * covariance is finished in place in thread 0's co-moment buffer and
+ * detached from it, so no d x d copy is made. With an arena, every
+ * buffer (including the returned covariance) lives in the arena.
+ */
+static int mean_covariance_pass(const Matrix *data, int n_threads, PCAArena *arena,
+                                double *mean, Matrix **cov) {
+    print_progress("Computing mean and covariance (single pass)...");
+    
+    n_threads = row_thread_count(n_threads, data->rows);
+    
+    MeanCovarianceTask *tasks = (MeanCovarianceTask*)scratch_calloc(arena, n_threads,
+                                                                    sizeof(MeanCovarianceTask));
+    if (!tasks) return -1;
+    
+    int ok = 1;
+    for (int t = 0; t < n_threads; t++) {
+        tasks[t].data = data;
+        tasks[t].row_start = (int)((long long)data->rows * t / n_threads);
+        tasks[t].row_end = (int)((long long)data->rows * (t + 1) / n_threads);
+        tasks[t].acc = ok ? cov_accumulator_alloc(arena, data->cols) : NULL;
+        if (!tasks[t].acc) ok = 0;
+    }
+    
+    if (ok) {
+        parallel_run(n_threads, mean_covariance_task, tasks, sizeof(MeanCovarianceTask));
+        for (int t = 0; t < n_threads; t++) {
+            if (tasks[t].status != 0) ok = 0;
+        }
+    }
+    
+    /* Merge per-thread statistics into thread 0's accumulator */
+    for (int t = 1; t < n_threads && ok; t++) {
+        if (cov_accumulator_merge(tasks[0].acc, tasks[t].acc) != 0) ok = 0;
+    }
+    
+    *cov = NULL;
+    if (ok) {
+        memcpy(mean, tasks[0].acc->mean, data->cols * sizeof(double));
+        comoment_to_covariance(tasks[0].acc->comoment, tasks[0].acc->count);
+        *cov = tasks[0].acc->comoment;
+        tasks[0].acc->comoment = NULL;
+    }
+    
+    if (!arena) {
+        for (int t = 0; t < n_threads; t++) {
+            cov_accumulator_free(tasks[t].acc);
+        }
+        free(tasks);
+    }
+    
+    if (!ok) {
+        print_error("Failed to compute mean and covariance");
+        return -1;
+    }
+    
+    printf("  Covariance matrix: %d x %d (%d thread%s)\n", data->cols, data->cols,
+           n_threads, (n_threads == 1) ? "" : "s");
+    
+    return 0;
+}
+
+int compute_mean_covariance(const Matrix *data, int n_threads,
+                            double **mean, Matrix **cov) {
+    if (!data || !mean || !cov) return -1;
+    
+    *mean = (double*)malloc(data->cols * sizeof(double));
+    *cov = NULL;
+    if (!*mean) return -1;
+    
+    if (mean_covariance_pass(data, n_threads, NULL, *mean, cov) != 0) {
+        free(*mean);
+        *mean = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+/* Feature columns centered and transposed per Gram-matrix update */
+#define GRAM_SLAB_COLS 256
+
+/* Gram matrix in the arena (or on the heap); the slab is released after use */
+static Matrix* gram_matrix(const Matrix *data, const double *mean, PCAArena *arena) {
+    int n = data->rows;
+    int d = data->cols;
+    if (n < 2) {
+        print_error("Gram matrix needs at least 2 samples");
+        return NULL;
+    }
+    
+    print_progress("Computing Gram matrix (X X^T, fewer samples than features)...");
+    
+    /*
+     * Xc Xc^T = sum over feature slabs S (n x c) of S S^T. Each slab is
+     * centered into a transposed c x n scratch buffer so the SYRK reads
+     * it as op(A) = S and B = S^T without another copy.
+     */
+    int slab_cols = (d < GRAM_SLAB_COLS) ? d : GRAM_SLAB_COLS;
+    Matrix *gram = scratch_matrix(arena, n, n);
+    size_t mark = pca_arena_mark(arena);
+    Matrix *slab = gram ? scratch_matrix(arena, slab_cols, n) : NULL;
+    double *pack = slab ? (double*)scratch_alloc(arena, gemm_pack_size(n, n, slab_cols, NULL) *
+                                                        sizeof(double)) : NULL;
+    if (!gram || !slab || !pack) {
+        print_error("Failed to allocate Gram matrix");
+        matrix_free(gram);
+        matrix_free(slab);
+        return NULL;
+    }
+    
+    for (int c0 = 0; c0 < d; c0 += slab_cols) {
+        int cols = (d - c0 < slab_cols) ? d - c0 : slab_cols;
+        
+        for (int i = 0; i < n; i++) {
+            const double *row = MATRIX_ROW(data, i) + c0;
+            for (int j = 0; j < cols; j++) {
+                MATRIX_ROW(slab, j)[i] = row[j] - mean[c0 + j];
+            }
+        }
+        
+        gemm_driver(n, n, cols, slab->values, slab->stride, 1,
+                    slab->values, slab->stride, gram->values, gram->stride, 1, pack);
+    }
+    matrix_free(slab);
+    scratch_free(arena, pack);
+    pca_arena_release(arena, mark);
+    
+    symmetrize_upper(gram->values, n, gram->stride);
+    
+    double scale = 1.0 / (n - 1);
+    for (size_t i = 0; i < (size_t)n * gram->stride; i++) {
+        gram->values[i] *= scale;
+    }
+    
+    printf("  Gram matrix: %d x %d (instead of %d x %d covariance)\n", n, n, d, d);
+    
+    return gram;
+}
+
+Matrix* compute_gram_matrix(const Matrix *data, const double *mean) {
+    if (!data || !mean) return NULL;
+    
+    return gram_matrix(data, mean, NULL);
+}
+
+/* ============================================
+ * PCA Core Algorithm Implementation
+ * ============================================ */
+
+int compute_eigen(const Matrix *cov_matrix, double *eigenvalues, 
+                 Matrix *eigenvectors, int max_iterations, double tolerance) {
+    if (!cov_matrix) return -1;
+    
+    return compute_eigen_topk(cov_matrix, cov_matrix->rows, eigenvalues,
+                              eigenvectors, max_iterations, tolerance, NULL);
+}
+
+/*
+ * Eigen solver workspace: every eigen backend takes its buffers from it,
+ * including the dense solves of the projected problems and the GEMM
+ * packing space. Each buffer set is (re)sized on first use for a given
+ * shape, so repeated fits of the same shape do not allocate.
+ */
+EigenWorkspace* eigen_workspace_create(void) {
+    EigenWorkspace *ws = (EigenWorkspace*)calloc(1, sizeof(EigenWorkspace));
+    if (!ws) {
+        print_error("Failed to allocate eigen workspace");
+    }
+    return ws;
+}
+
+static void eigen_workspace_release_power(EigenWorkspace *ws) {
+    matrix_free(ws->A);
+    scratch_free(ws->arena, ws->v[0]);
+    scratch_free(ws->arena, ws->v[1]);
+    ws->A = NULL;
+    ws->v[0] = NULL;
+    ws->v[1] = NULL;
+    ws->power_dim = 0;
+}
+
+static void eigen_workspace_release_block(EigenWorkspace *ws) {
+    matrix_free(ws->Q);
+    matrix_free(ws->Z);
+    matrix_free(ws->T);
+    matrix_free(ws->H);
+    matrix_free(ws->W);
+    scratch_free(ws->arena, ws->theta);
+    scratch_free(ws->arena, ws->tau);
+    scratch_free(ws->arena, ws->qr_row);
+    ws->Q = ws->Z = ws->T = ws->H = ws->W = NULL;
+    ws->theta = ws->tau = ws->qr_row = NULL;
+    ws->block_dim = 0;
+    ws->block = 0;
+}
+
+static void eigen_workspace_release_dense(EigenWorkspace *ws) {
+    matrix_free(ws->U);
+    matrix_free(ws->U_t);
+    scratch_free(ws->arena, ws->diag);
+    scratch_free(ws->arena, ws->offdiag);
+    scratch_free(ws->arena, ws->order);
+    ws->U = ws->U_t = NULL;
+    ws->diag = ws->offdiag = NULL;
+    ws->order = NULL;
+    ws->dense_dim = 0;
+}
+
+static void eigen_workspace_release_lanczos(EigenWorkspace *ws) {
+    LanczosWorkspace *lz = &ws->lanczos;
+    matrix_free(lz->V);
+    matrix_free(lz->V_next);
+    matrix_free(lz->H);
+    matrix_free(lz->H_sym);
+    matrix_free(lz->Y);
+    scratch_free(ws->arena, lz->theta);
+    scratch_free(ws->arena, lz->res);
+    scratch_free(ws->arena, lz->w);
+    scratch_free(ws->arena, lz->r);
+    scratch_free(ws->arena, lz->h);
+    memset(lz, 0, sizeof(*lz));
+}
+
+static void eigen_workspace_release_pack(EigenWorkspace *ws) {
+    scratch_free(ws->arena, ws->pack);
+    ws->pack = NULL;
+    ws->pack_size = 0;
+}
+
+void eigen_workspace_free(EigenWorkspace *ws) {
+    if (!ws) return;
+    eigen_workspace_release_power(ws);
+    eigen_workspace_release_block(ws);
+    eigen_workspace_release_dense(ws);
+    eigen_workspace_release_lanczos(ws);
+    eigen_workspace_release_pack(ws);
+    free(ws);
+}
+
+/* Size the power-iteration buffers for a dim x dim matrix (no-op if they fit) */
+static int eigen_workspace_reserve_power(EigenWorkspace *ws, int dim) {
+    if (ws->power_dim == dim) return 0;
+    
+    eigen_workspace_release_power(ws);
+    ws->A = scratch_matrix(ws->arena, dim, dim);
+    ws->v[0] = (double*)scratch_alloc(ws->arena, dim * sizeof(double));
+    ws->v[1] = (double*)scratch_alloc(ws->arena, dim * sizeof(double));
+    if (!ws->A || !ws->v[0] || !ws->v[1]) {
+        eigen_workspace_release_power(ws);
+        return -1;
+    }
+    ws->power_dim = dim;
+    return 0;
+}
+
+/* Size the subspace-iteration buffers for a dim x block block (no-op if they fit) */
+static int eigen_workspace_reserve_block(EigenWorkspace *ws, int dim, int block) {
+    if (ws->block_dim == dim && ws->block == block) return 0;
+    
+    eigen_workspace_release_block(ws);
+    ws->Q = scratch_matrix(ws->arena, dim, block);
+    ws->Z = scratch_matrix(ws->arena, dim, block);
+    ws->T = scratch_matrix(ws->arena, dim, block);
+    ws->H = scratch_matrix(ws->arena, block, block);
+    ws->W = scratch_matrix(ws->arena, block, block);
+    ws->theta = (double*)scratch_alloc(ws->arena, block * sizeof(double));
+    ws->tau = (double*)scratch_alloc(ws->arena, block * sizeof(double));
+    ws->qr_row = (double*)scratch_alloc(ws->arena, block * sizeof(double));
+    if (!ws->Q || !ws->Z || !ws->T || !ws->H || !ws->W || !ws->theta ||
+        !ws->tau || !ws->qr_row) {
+        eigen_workspace_release_block(ws);
+        return -1;
+    }
+    ws->block_dim = dim;
+    ws->block = block;
+    return 0;
+}
+
+/* Size the dense-solve buffers for a dim x dim matrix (no-op if they fit) */
+static int eigen_workspace_reserve_dense(EigenWorkspace *ws, int dim) {
+    if (ws->dense_dim == dim) return 0;
+    
+    eigen_workspace_release_dense(ws);
+    ws->U = scratch_matrix(ws->arena, dim, dim);
+    ws->U_t = scratch_matrix(ws->arena, dim, dim);
+    ws->diag = (double*)scratch_alloc(ws->arena, dim * sizeof(double));
+    ws->offdiag = (double*)scratch_alloc(ws->arena, dim * sizeof(double));
+    ws->order = (int*)scratch_alloc(ws->arena, dim * sizeof(int));
+    if (!ws->U || !ws->U_t || !ws->diag || !ws->offdiag || !ws->order) {
+        eigen_workspace_release_dense(ws);
+        return -1;
+    }
+    ws->dense_dim = dim;
+    return 0;
+}
+
+/* Size the Lanczos buffers for an m-vector basis of length d (no-op if they fit) */
+static int eigen_workspace_reserve_lanczos(EigenWorkspace *ws, int m, int d) {
+    LanczosWorkspace *lz = &ws->lanczos;
+    if (lz->dim == d && lz->basis == m) return 0;
+    
+    eigen_workspace_release_lanczos(ws);
+    lz->V = scratch_matrix(ws->arena, m, d);
+    lz->V_next = scratch_matrix(ws->arena, m, d);
+    lz->H = scratch_matrix(ws->arena, m, m);
+    lz->H_sym = scratch_matrix(ws->arena, m, m);
+    lz->Y = scratch_matrix(ws->arena, m, m);
+    lz->theta = (double*)scratch_alloc(ws->arena, m * sizeof(double));
+    lz->res = (double*)scratch_alloc(ws->arena, m * sizeof(double));
+    lz->w = (double*)scratch_alloc(ws->arena, d * sizeof(double));
+    lz->r = (double*)scratch_alloc(ws->arena, d * sizeof(double));
+    lz->h = (double*)scratch_alloc(ws->arena, m * sizeof(double));
+    if (!lz->V || !lz->V_next || !lz->H || !lz->H_sym || !lz->Y ||
+        !lz->theta || !lz->res || !lz->w || !lz->r || !lz->h) {
+        eigen_workspace_release_lanczos(ws);
+        return -1;
+    }
+    lz->dim = d;
+    lz->basis = m;
+    return 0;
+}
+
+/* Grow the GEMM packing buffer to at least size doubles (no-op if it fits) */
+static int eigen_workspace_reserve_pack(EigenWorkspace *ws, size_t size) {
+    if (ws->pack_size >= size) return 0;
+    
+    eigen_workspace_release_pack(ws);
+    ws->pack = (double*)scratch_alloc(ws->arena, size * sizeof(double));
+    if (!ws->pack) return -1;
+    ws->pack_size = size;
+    return 0;
+}
+
+/*
+ * Deterministic pseudo-random numbers (splitmix64 + Box-Muller) for
+ * starting vectors, so iterative solvers are reproducible run to run.
+ */
+typedef struct {
+    unsigned long long state;
+    int has_spare;
+    double spare;
+} RandomState;
+
+static void random_seed(RandomState *rng, unsigned long long seed) {
+    rng->state = seed;
+    rng->has_spare = 0;
+    rng->spare = 0.0;
+}
+
+/* Uniform in (0, 1) */
+static double random_uniform(RandomState *rng) {
+    unsigned long long z = (rng->state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    return ((double)(z >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+static double random_gaussian(RandomState *rng) {
+    if (rng->has_spare) {
+        rng->has_spare = 0;
+        return rng->spare;
+    }
+    double u1 = random_uniform(rng);
+    double u2 = random_uniform(rng);
+    double r = sqrt(-2.0 * log(u1));
+    rng->spare = r * sin(2.0 * M_PI * u2);
+    rng->has_spare = 1;
+    return r * cos(2.0 * M_PI * u2);
+}
+
+/* Power iteration with deflation on workspace buffers; no allocation */
+static void power_iteration_topk(const Matrix *cov_matrix, int n_eigen, double *eigenvalues,
+                                 Matrix *eigenvectors, int max_iterations, double tolerance,
+                                 EigenWorkspace *ws) {
+    int n = cov_matrix->rows;
+    Matrix *A = ws->A;
+    
+    /* Copy covariance matrix (we'll deflate it) */
+    matrix_copy(A, cov_matrix);
+    
+    RandomState rng;
+    random_seed(&rng, 0x5CA1AB1EULL);
+    
+    /* Power iteration for each of the leading eigenvectors */
+    for (int k = 0; k < n_eigen; k++) {
+        /* v and v_new ping-pong between the two workspace buffers */
+        int cur = 0;
+        double *v = ws->v[cur];
+        
+        /* Initialize with random values: a constant start lies in the
+         * null space of a centered Gram matrix and would stay at zero */
+        for (int i = 0; i < n; i++) {
+            v[i] = random_gaussian(&rng);
+        }
+        vector_normalize(v, n);
+        
+        /* Power iteration */
+        double lambda = 0.0;
+        for (int iter = 0; iter < max_iterations; iter++) {
+            /* v_new = A * v */
+            double *v_new = ws->v[cur ^ 1];
+            for (int i = 0; i < n; i++) {
+                const double *a_row = MATRIX_ROW(A, i);
+                double sum = 0.0;
+                for (int j = 0; j < n; j++) {
+                    sum += a_row[j] * v[j];
+                }
+                v_new[i] = sum;
+            }
+            
             /* Compute eigenvalue (Rayleigh quotient) */
             double lambda_new = 0.0;
             for (int i = 0; i < n; i++) {
@@ -363,90 +3775,1735 @@ int compute_eigen(const Matrix *cov_matrix, double *eigenvalues,
             /* Normalize */
             vector_normalize(v_new, n);
             
+            cur ^= 1;
+            v = v_new;
+            
             /* Check convergence */
-            if (fabs(lambda_new - lambda) < tolerance) {
-                lambda = lambda_new;
-                memcpy(v, v_new, n * sizeof(double));
-                free(v_new);
-                break;
+            int converged = fabs(lambda_new - lambda) < tolerance;
+            lambda = lambda_new;
+            if (converged) break;
+        }
+        
+        /* Store eigenvalue and eigenvector */
+        eigenvalues[k] = lambda;
+        for (int i = 0; i < n; i++) {
+            MATRIX_ROW(eigenvectors, i)[k] = v[i];
+        }
+        
+        /* Deflate matrix: A = A - lambda * v * v^T (not needed after the last pair) */
+        if (k + 1 < n_eigen) {
+            for (int i = 0; i < n; i++) {
+                double *a_row = MATRIX_ROW(A, i);
+                double lv = lambda * v[i];
+                for (int j = 0; j < n; j++) {
+                    a_row[j] -= lv * v[j];
+                }
+            }
+        }
+    }
+}
+
+int compute_eigen_topk(const Matrix *cov_matrix, int n_eigen, double *eigenvalues,
+                       Matrix *eigenvectors, int max_iterations, double tolerance,
+                       EigenWorkspace *workspace) {
+    if (!cov_matrix || !eigenvalues || !eigenvectors) return -1;
+    if (n_eigen <= 0 || n_eigen > cov_matrix->rows ||
+        eigenvectors->rows != cov_matrix->rows || eigenvectors->cols < n_eigen) {
+        print_error("Invalid eigensolver dimensions");
+        return -1;
+    }
+    
+    print_progress("Computing eigenvalues and eigenvectors...");
+    
+    int n = cov_matrix->rows;
+    EigenWorkspace *ws = workspace ? workspace : eigen_workspace_create();
+    if (!ws || eigen_workspace_reserve_power(ws, n) != 0) {
+        print_error("Failed to allocate eigen workspace");
+        if (ws != workspace) eigen_workspace_free(ws);
+        return -1;
+    }
+    
+    power_iteration_topk(cov_matrix, n_eigen, eigenvalues, eigenvectors,
+                         max_iterations, tolerance, ws);
+    
+    if (ws != workspace) eigen_workspace_free(ws);
+    
+    printf("  Computed %d of %d eigenvalues\n", n_eigen, n);
+    
+    return 0;
+}
+
+/*
+ * Dense symmetric eigensolver: Householder reduction to tridiagonal form
+ * followed by the implicit-shift QL algorithm (EISPACK tred2/tql2).
+ * Cost is a deterministic O(d^3) and the eigenvectors are orthogonal to
+ * working precision. The QL sweeps apply Givens rotations to rows of the
+ * transposed eigenvector matrix so every rotation streams contiguous
+ * memory.
+ */
+
+/* Householder tridiagonalization. On entry V holds A; on exit V holds the
+ * orthogonal transform, diag the diagonal and offdiag the subdiagonal
+ * (offdiag[i] couples i-1 and i). */
+static void tridiagonalize(Matrix *V, double *diag, double *offdiag) {
+    int n = V->rows;
+    double **v = V->data;
+    
+    for (int j = 0; j < n; j++) {
+        diag[j] = v[n - 1][j];
+    }
+    
+    for (int i = n - 1; i > 0; i--) {
+        double scale = 0.0;
+        double h = 0.0;
+        for (int k = 0; k < i; k++) {
+            scale += fabs(diag[k]);
+        }
+        
+        if (scale == 0.0) {
+            offdiag[i] = diag[i - 1];
+            for (int j = 0; j < i; j++) {
+                diag[j] = v[i - 1][j];
+                v[i][j] = 0.0;
+                v[j][i] = 0.0;
+            }
+        } else {
+            /* Generate the Householder vector */
+            for (int k = 0; k < i; k++) {
+                diag[k] /= scale;
+                h += diag[k] * diag[k];
+            }
+            double f = diag[i - 1];
+            double g = sqrt(h);
+            if (f > 0) g = -g;
+            offdiag[i] = scale * g;
+            h -= f * g;
+            diag[i - 1] = f - g;
+            for (int j = 0; j < i; j++) {
+                offdiag[j] = 0.0;
+            }
+            
+            /* Apply the similarity transform to the remaining columns */
+            for (int j = 0; j < i; j++) {
+                f = diag[j];
+                v[j][i] = f;
+                g = offdiag[j] + v[j][j] * f;
+                for (int k = j + 1; k <= i - 1; k++) {
+                    g += v[k][j] * diag[k];
+                    offdiag[k] += v[k][j] * f;
+                }
+                offdiag[j] = g;
+            }
+            f = 0.0;
+            for (int j = 0; j < i; j++) {
+                offdiag[j] /= h;
+                f += offdiag[j] * diag[j];
+            }
+            double hh = f / (h + h);
+            for (int j = 0; j < i; j++) {
+                offdiag[j] -= hh * diag[j];
+            }
+            for (int j = 0; j < i; j++) {
+                f = diag[j];
+                g = offdiag[j];
+                for (int k = j; k <= i - 1; k++) {
+                    v[k][j] -= (f * offdiag[k] + g * diag[k]);
+                }
+                diag[j] = v[i - 1][j];
+                v[i][j] = 0.0;
+            }
+        }
+        diag[i] = h;
+    }
+    
+    /* Accumulate the transformations */
+    for (int i = 0; i < n - 1; i++) {
+        v[n - 1][i] = v[i][i];
+        v[i][i] = 1.0;
+        double h = diag[i + 1];
+        if (h != 0.0) {
+            for (int k = 0; k <= i; k++) {
+                diag[k] = v[k][i + 1] / h;
+            }
+            for (int j = 0; j <= i; j++) {
+                double g = 0.0;
+                for (int k = 0; k <= i; k++) {
+                    g += v[k][i + 1] * v[k][j];
+                }
+                for (int k = 0; k <= i; k++) {
+                    v[k][j] -= g * diag[k];
+                }
+            }
+        }
+        for (int k = 0; k <= i; k++) {
+            v[k][i + 1] = 0.0;
+        }
+    }
+    for (int j = 0; j < n; j++) {
+        diag[j] = v[n - 1][j];
+        v[n - 1][j] = 0.0;
+    }
+    v[n - 1][n - 1] = 1.0;
+    offdiag[0] = 0.0;
+}
+
+/* Maximum QL sweeps per eigenvalue before giving up */
+#define QL_MAX_SWEEPS 64
+
+/* Implicit-shift QL on the tridiagonal (diag, offdiag). Z holds the
+ * transposed transform from tridiagonalize(): row i of Z becomes the
+ * eigenvector of diag[i]. Returns 0 on success, -1 if a sweep limit is hit. */
+static int tridiagonal_ql(double *diag, double *offdiag, Matrix *Z) {
+    int n = Z->rows;
+    
+    for (int i = 1; i < n; i++) {
+        offdiag[i - 1] = offdiag[i];
+    }
+    offdiag[n - 1] = 0.0;
+    
+    double f = 0.0;
+    double tst1 = 0.0;
+    const double eps = 2.220446049250313e-16;
+    
+    for (int l = 0; l < n; l++) {
+        /* Find a small subdiagonal element */
+        double t = fabs(diag[l]) + fabs(offdiag[l]);
+        if (t > tst1) tst1 = t;
+        int m = l;
+        while (m < n - 1 && fabs(offdiag[m]) > eps * tst1) {
+            m++;
+        }
+        
+        if (m > l) {
+            int sweeps = 0;
+            do {
+                if (++sweeps > QL_MAX_SWEEPS) return -1;
+                
+                /* Compute the implicit shift */
+                double g = diag[l];
+                double p = (diag[l + 1] - g) / (2.0 * offdiag[l]);
+                double r = hypot(p, 1.0);
+                if (p < 0) r = -r;
+                diag[l] = offdiag[l] / (p + r);
+                diag[l + 1] = offdiag[l] * (p + r);
+                double dl1 = diag[l + 1];
+                double h = g - diag[l];
+                for (int i = l + 2; i < n; i++) {
+                    diag[i] -= h;
+                }
+                f += h;
+                
+                /* QL sweep from m - 1 down to l */
+                p = diag[m];
+                double c = 1.0, c2 = 1.0, c3 = 1.0;
+                double el1 = offdiag[l + 1];
+                double s = 0.0, s2 = 0.0;
+                for (int i = m - 1; i >= l; i--) {
+                    c3 = c2;
+                    c2 = c;
+                    s2 = s;
+                    g = c * offdiag[i];
+                    h = c * p;
+                    r = hypot(p, offdiag[i]);
+                    offdiag[i + 1] = s * r;
+                    s = offdiag[i] / r;
+                    c = p / r;
+                    p = c * diag[i] - s * g;
+                    diag[i + 1] = h + s * (c * g + s * diag[i]);
+                    
+                    /* Rotate rows i and i + 1 of Z */
+                    double *zi = MATRIX_ROW(Z, i);
+                    double *zi1 = MATRIX_ROW(Z, i + 1);
+                    for (int k = 0; k < n; k++) {
+                        double zk = zi1[k];
+                        zi1[k] = s * zi[k] + c * zk;
+                        zi[k] = c * zi[k] - s * zk;
+                    }
+                }
+                p = -s * s2 * c3 * el1 * offdiag[l] / dl1;
+                offdiag[l] = s * p;
+                diag[l] = c * p;
+            } while (fabs(offdiag[l]) > eps * tst1);
+        }
+        diag[l] += f;
+        offdiag[l] = 0.0;
+    }
+    
+    return 0;
+}
+
+/* Dense solve without progress output, shared by the small projected
+ * problems of the iterative solvers. Returns the n_eigen largest pairs.
+ * The dense buffers of ws must be reserved for A->rows. */
+static int dense_eigen_solve(const Matrix *A, int n_eigen, double *eigenvalues,
+                             Matrix *eigenvectors, EigenWorkspace *ws) {
+    int n = A->rows;
+    Matrix *V = ws->U;
+    Matrix *Z = ws->U_t;
+    double *diag = ws->diag;
+    double *offdiag = ws->offdiag;
+    int *order = ws->order;
+    
+    matrix_copy(V, A);
+    tridiagonalize(V, diag, offdiag);
+    
+    /* Work on the transpose so QL rotations touch contiguous rows */
+    for (int i = 0; i < n; i++) {
+        const double *v = MATRIX_ROW(V, i);
+        for (int j = 0; j < n; j++) {
+            MATRIX_ROW(Z, j)[i] = v[j];
+        }
+    }
+    
+    int result = tridiagonal_ql(diag, offdiag, Z);
+    
+    if (result == 0) {
+        /* Select the n_eigen largest eigenvalues in descending order */
+        for (int i = 0; i < n; i++) {
+            order[i] = i;
+        }
+        for (int i = 0; i < n_eigen; i++) {
+            int best = i;
+            for (int j = i + 1; j < n; j++) {
+                if (diag[order[j]] > diag[order[best]]) best = j;
+            }
+            int tmp = order[i];
+            order[i] = order[best];
+            order[best] = tmp;
+            
+            eigenvalues[i] = diag[order[i]];
+            const double *z = MATRIX_ROW(Z, order[i]);
+            for (int r = 0; r < n; r++) {
+                MATRIX_ROW(eigenvectors, r)[i] = z[r];
+            }
+        }
+    }
+    
+    return result;
+}
+
+int compute_eigen_dense(const Matrix *cov_matrix, int n_eigen, double *eigenvalues,
+                        Matrix *eigenvectors, EigenWorkspace *workspace) {
+    if (!cov_matrix || !eigenvalues || !eigenvectors) return -1;
+    if (n_eigen <= 0 || n_eigen > cov_matrix->rows ||
+        eigenvectors->rows != cov_matrix->rows || eigenvectors->cols < n_eigen) {
+        print_error("Invalid eigensolver dimensions");
+        return -1;
+    }
+    
+    print_progress("Computing eigenvalues and eigenvectors (Householder + QL)...");
+    
+    EigenWorkspace *ws = workspace ? workspace : eigen_workspace_create();
+    if (!ws || eigen_workspace_reserve_dense(ws, cov_matrix->rows) != 0) {
+        print_error("Failed to allocate eigen workspace");
+        if (ws != workspace) eigen_workspace_free(ws);
+        return -1;
+    }
+    
+    int result = dense_eigen_solve(cov_matrix, n_eigen, eigenvalues, eigenvectors, ws);
+    if (result == 0) {
+        printf("  Computed %d of %d eigenvalues\n", n_eigen, cov_matrix->rows);
+    } else {
+        print_error("QL iteration did not converge");
+    }
+    
+    if (ws != workspace) eigen_workspace_free(ws);
+    
+    return result;
+}
+
+static void dense_operator_apply(const double *x, double *y, void *ctx) {
+    const Matrix *A = (const Matrix*)ctx;
+    for (int i = 0; i < A->rows; i++) {
+        y[i] = vector_dot(MATRIX_ROW(A, i), x, A->cols);
+    }
+}
+
+void linear_operator_from_matrix(LinearOperator *op, const Matrix *A) {
+    op->dim = A->rows;
+    op->apply = dense_operator_apply;
+    op->ctx = (void*)A;
+    op->destroy = NULL;
+}
+
+/*
+ * Matrix-free covariance operator: y = (X - 1 m^T)^T (X - 1 m^T) v / (n - 1)
+ * is applied without forming the d x d matrix. Each row is centered on
+ * the fly, u_i = (x_i - m) . v, and u_i (x_i - m) is accumulated into y
+ * while the row is still in cache, so one product streams X once. Rows
+ * are split across threads, each with a private y, summed at the end.
+ */
+typedef struct {
+    const Matrix *data;
+    const double *mean;
+    double scale;               /* 1 / (n - 1) */
+    int n_threads;
+    double *partials;           /* n_threads x d private accumulators */
+    struct CovarianceApplyTask *tasks;
+} CovarianceOperator;
+
+typedef struct CovarianceApplyTask {
+    const CovarianceOperator *cov_op;
+    const double *x;
+    double *y;
+    int row_start;
+    int row_end;
+} CovarianceApplyTask;
+
+static void covariance_apply_task(void *arg) {
+    CovarianceApplyTask *t = (CovarianceApplyTask*)arg;
+    const Matrix *data = t->cov_op->data;
+    const double *mean = t->cov_op->mean;
+    int d = data->cols;
+    
+    memset(t->y, 0, d * sizeof(double));
+    for (int i = t->row_start; i < t->row_end; i++) {
+        const double *row = MATRIX_ROW(data, i);
+        double u = 0.0;
+        for (int j = 0; j < d; j++) {
+            u += (row[j] - mean[j]) * t->x[j];
+        }
+        for (int j = 0; j < d; j++) {
+            t->y[j] += u * (row[j] - mean[j]);
+        }
+    }
+}
+
+static void covariance_operator_apply(const double *x, double *y, void *ctx) {
+    CovarianceOperator *cov_op = (CovarianceOperator*)ctx;
+    int d = cov_op->data->cols;
+    int n_threads = cov_op->n_threads;
+    CovarianceApplyTask *tasks = cov_op->tasks;
+    
+    for (int t = 0; t < n_threads; t++) {
+        tasks[t].cov_op = cov_op;
+        tasks[t].x = x;
+        tasks[t].y = cov_op->partials + (size_t)t * d;
+        tasks[t].row_start = (int)((long long)cov_op->data->rows * t / n_threads);
+        tasks[t].row_end = (int)((long long)cov_op->data->rows * (t + 1) / n_threads);
+    }
+    parallel_run(n_threads, covariance_apply_task, tasks, sizeof(CovarianceApplyTask));
+    
+    for (int j = 0; j < d; j++) {
+        double sum = 0.0;
+        for (int t = 0; t < n_threads; t++) {
+            sum += cov_op->partials[(size_t)t * d + j];
+        }
+        y[j] = sum * cov_op->scale;
+    }
+}
+
+static void covariance_operator_destroy(void *ctx) {
+    CovarianceOperator *cov_op = (CovarianceOperator*)ctx;
+    if (!cov_op) return;
+    free(cov_op->partials);
+    free(cov_op->tasks);
+    free(cov_op);
+}
+
+int linear_operator_covariance(LinearOperator *op, const Matrix *data,
+                               const double *mean, int n_threads) {
+    if (!op || !data || !mean) return -1;
+    
+    CovarianceOperator *cov_op = (CovarianceOperator*)malloc(sizeof(CovarianceOperator));
+    if (!cov_op) return -1;
+    
+    n_threads = row_thread_count(n_threads, data->rows);
+    
+    cov_op->data = data;
+    cov_op->mean = mean;
+    cov_op->scale = 1.0 / ((data->rows > 1) ? (data->rows - 1) : 1);
+    cov_op->n_threads = n_threads;
+    cov_op->partials = (double*)malloc((size_t)n_threads * data->cols * sizeof(double));
+    cov_op->tasks = (CovarianceApplyTask*)malloc(n_threads * sizeof(CovarianceApplyTask));
+    if (!cov_op->partials || !cov_op->tasks) {
+        covariance_operator_destroy(cov_op);
+        return -1;
+    }
+    
+    op->dim = data->cols;
+    op->apply = covariance_operator_apply;
+    op->ctx = cov_op;
+    op->destroy = covariance_operator_destroy;
+    return 0;
+}
+
+void linear_operator_release(LinearOperator *op) {
+    if (!op) return;
+    if (op->destroy) op->destroy(op->ctx);
+    op->ctx = NULL;
+    op->destroy = NULL;
+}
+
+/* Per-feature mean and sample variance in one pass (Welford, row-wise) */
+static int compute_mean_variance(const Matrix *data, double *mean, double *variance) {
+    int d = data->cols;
+    double *m2 = variance;
+    
+    memset(mean, 0, d * sizeof(double));
+    memset(m2, 0, d * sizeof(double));
+    
+    for (int i = 0; i < data->rows; i++) {
+        const double *row = MATRIX_ROW(data, i);
+        double inv_n = 1.0 / (i + 1);
+        for (int j = 0; j < d; j++) {
+            double delta = row[j] - mean[j];
+            mean[j] += delta * inv_n;
+            m2[j] += delta * (row[j] - mean[j]);
+        }
+    }
+    
+    double scale = 1.0 / ((data->rows > 1) ? (data->rows - 1) : 1);
+    for (int j = 0; j < d; j++) {
+        variance[j] = m2[j] * scale;
+    }
+    return 0;
+}
+
+/*
+ * Orthogonalize w against the first `count` rows of V with two passes of
+ * classical Gram-Schmidt; the projection coefficients are added to coef
+ * when it is not NULL.
+ */
+static void orthogonalize_rows(const Matrix *V, int count, double *w, double *coef) {
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; i < count; i++) {
+            double c = vector_dot(MATRIX_ROW(V, i), w, V->cols);
+            const double *v = MATRIX_ROW(V, i);
+            for (int t = 0; t < V->cols; t++) {
+                w[t] -= c * v[t];
+            }
+            if (coef) coef[i] += c;
+        }
+    }
+}
+
+/* Fill w with a random unit vector orthogonal to the first count rows of V */
+static void random_orthogonal_vector(const Matrix *V, int count, double *w,
+                                     RandomState *rng) {
+    for (int attempt = 0; attempt < 3; attempt++) {
+        for (int t = 0; t < V->cols; t++) {
+            w[t] = random_gaussian(rng);
+        }
+        orthogonalize_rows(V, count, w, NULL);
+        if (vector_norm(w, V->cols) > 1e-8) break;
+    }
+    vector_normalize(w, V->cols);
+}
+
+/* Extra Krylov vectors kept beyond n_eigen */
+#define LANCZOS_MIN_EXTRA 20
+
+/*
+ * Thick-restart Lanczos (the symmetric form of Krylov-Schur) with full
+ * reorthogonalization. The basis is stored one vector per row so every
+ * dot product and update is contiguous. After each cycle of m steps the
+ * projected matrix H = V^T A V is solved densely (Rayleigh-Ritz), the
+ * residual of Ritz pair i is |beta_m * y_i[m-1]|, and the basis is
+ * restarted from the leading Ritz vectors plus the residual direction.
+ */
+
+/*
+ * Run restart cycles until the k leading Ritz pairs have residuals below
+ * tolerance * |theta_0| or max_restarts is reached. On return theta, Y,
+ * V and res of ws->lanczos describe the final Rayleigh-Ritz step.
+ * Returns the number of restarts, or -1 on failure; *converged is set.
+ */
+static int lanczos_iterate(const LinearOperator *op, EigenWorkspace *ws, int m, int k,
+                           int max_restarts, double tolerance, int *converged) {
+    int d = op->dim;
+    LanczosWorkspace *lz = &ws->lanczos;
+    Matrix *V = lz->V;
+    Matrix *H = lz->H;
+    Matrix *Y = lz->Y;
+    double *w = lz->w;
+    double *h = lz->h;
+    
+    RandomState rng;
+    random_seed(&rng, 0x5CA1AB1EULL);
+    random_orthogonal_vector(V, 0, MATRIX_ROW(V, 0), &rng);
+    
+    int start = 0;
+    int restart = 0;
+    double beta_m = 0.0;
+    double anorm = 0.0;
+    
+    for (;;) {
+        /* Extend the basis from `start` to m vectors */
+        for (int j = start; j < m; j++) {
+            op->apply(MATRIX_ROW(V, j), w, op->ctx);
+            
+            memset(h, 0, (j + 1) * sizeof(double));
+            orthogonalize_rows(V, j + 1, w, h);
+            for (int i = 0; i <= j; i++) {
+                MATRIX_ROW(H, i)[j] = h[i];
+                if (fabs(h[i]) > anorm) anorm = fabs(h[i]);
             }
             
-            lambda = lambda_new;
-            memcpy(v, v_new, n * sizeof(double));
-            free(v_new);
+            double beta = vector_norm(w, d);
+            if (j + 1 < m) {
+                double *v_next = MATRIX_ROW(V, j + 1);
+                if (beta <= 1e-12 * anorm) {
+                    /* Invariant subspace found: continue with a fresh direction */
+                    random_orthogonal_vector(V, j + 1, v_next, &rng);
+                } else {
+                    for (int t = 0; t < d; t++) {
+                        v_next[t] = w[t] / beta;
+                    }
+                }
+            } else {
+                memcpy(lz->r, w, d * sizeof(double));
+                beta_m = beta;
+            }
         }
         
-        /* Store eigenvalue and eigenvector */
-        eigenvalues[k] = lambda;
-        for (int i = 0; i < n; i++) {
-            eigenvectors->data[i][k] = v[i];
+        /* Rayleigh-Ritz on the symmetric projected matrix */
+        matrix_copy(lz->H_sym, H);
+        symmetrize_upper(lz->H_sym->values, m, lz->H_sym->stride);
+        if (dense_eigen_solve(lz->H_sym, m, lz->theta, Y, ws) != 0) {
+            print_error("Rayleigh-Ritz solve did not converge");
+            return -1;
         }
         
-        /* Deflate matrix: A = A - lambda * v * v^T */
-        for (int i = 0; i < n; i++) {
-            for (int j = 0; j < n; j++) {
-                A->data[i][j] -= lambda * v[i] * v[j];
+        *converged = 1;
+        double scale = (fabs(lz->theta[0]) > 0.0) ? fabs(lz->theta[0]) : 1.0;
+        for (int i = 0; i < m; i++) {
+            lz->res[i] = fabs(beta_m * MATRIX_ROW(Y, m - 1)[i]);
+            if (i < k && lz->res[i] > tolerance * scale) *converged = 0;
+        }
+        
+        if (*converged || m == d || restart >= max_restarts) break;
+        restart++;
+        
+        /* Thick restart: keep the leading p Ritz vectors, V <- Y_p^T V */
+        int p = k + (m - k) / 2;
+        if (p >= m) p = m - 1;
+        
+        Matrix *V_next = lz->V_next;
+        memset(V_next->values, 0, (size_t)p * V_next->stride * sizeof(double));
+        gemm_driver(p, d, m, Y->values, Y->stride, 1, V->values, V->stride,
+                    V_next->values, V_next->stride, 0, ws->pack);
+        memcpy(V->values, V_next->values, (size_t)p * V->stride * sizeof(double));
+        
+        memset(H->values, 0, (size_t)m * H->stride * sizeof(double));
+        for (int i = 0; i < p; i++) {
+            MATRIX_ROW(H, i)[i] = lz->theta[i];
+        }
+        
+        /* Continue from the residual direction */
+        double *v_p = MATRIX_ROW(V, p);
+        if (beta_m <= 1e-12 * anorm) {
+            random_orthogonal_vector(V, p, v_p, &rng);
+        } else {
+            for (int t = 0; t < d; t++) {
+                v_p[t] = lz->r[t] / beta_m;
+            }
+        }
+        start = p;
+    }
+    
+    return restart;
+}
+
+int compute_eigen_lanczos(const LinearOperator *op, int n_eigen, double *eigenvalues,
+                          Matrix *eigenvectors, double *residuals,
+                          int max_restarts, double tolerance,
+                          EigenWorkspace *workspace) {
+    if (!op || !op->apply || !eigenvalues || !eigenvectors) return -1;
+    
+    int d = op->dim;
+    int k = n_eigen;
+    if (k <= 0 || k > d || eigenvectors->rows != d || eigenvectors->cols < k) {
+        print_error("Invalid eigensolver dimensions");
+        return -1;
+    }
+    
+    print_progress("Computing eigenvalues and eigenvectors (thick-restart Lanczos)...");
+    
+    int m = k + ((k > LANCZOS_MIN_EXTRA) ? k : LANCZOS_MIN_EXTRA);
+    if (m > d) m = d;
+    
+    /* The restart and Ritz-vector products are at most m x d x m */
+    EigenWorkspace *ws = workspace ? workspace : eigen_workspace_create();
+    if (!ws || eigen_workspace_reserve_lanczos(ws, m, d) != 0 ||
+        eigen_workspace_reserve_dense(ws, m) != 0 ||
+        eigen_workspace_reserve_pack(ws, gemm_pack_size(m, d, m, NULL)) != 0) {
+        print_error("Failed to allocate Lanczos workspace");
+        if (ws != workspace) eigen_workspace_free(ws);
+        return -1;
+    }
+    LanczosWorkspace *lz = &ws->lanczos;
+    
+    int converged = 0;
+    int restarts = lanczos_iterate(op, ws, m, k, max_restarts, tolerance, &converged);
+    if (restarts < 0) {
+        if (ws != workspace) eigen_workspace_free(ws);
+        return -1;
+    }
+    
+    /* Ritz vectors for the k leading pairs: X = Y_k^T V */
+    memset(lz->V_next->values, 0, (size_t)k * lz->V_next->stride * sizeof(double));
+    gemm_driver(k, d, m, lz->Y->values, lz->Y->stride, 1, lz->V->values, lz->V->stride,
+                lz->V_next->values, lz->V_next->stride, 0, ws->pack);
+    
+    double max_residual = 0.0;
+    for (int i = 0; i < k; i++) {
+        eigenvalues[i] = lz->theta[i];
+        if (residuals) residuals[i] = lz->res[i];
+        if (lz->res[i] > max_residual) max_residual = lz->res[i];
+        const double *x = MATRIX_ROW(lz->V_next, i);
+        for (int t = 0; t < d; t++) {
+            MATRIX_ROW(eigenvectors, t)[i] = x[t];
+        }
+    }
+    
+    printf("  Computed %d of %d eigenvalues (%d restart%s, max residual %.3e)\n",
+           k, d, restarts, (restarts == 1) ? "" : "s", max_residual);
+    if (!converged && m < d) {
+        printf("  WARNING: Lanczos stopped after %d restarts before reaching tolerance %.1e\n",
+               restarts, tolerance);
+    }
+    
+    if (ws != workspace) eigen_workspace_free(ws);
+    return 0;
+}
+
+/* Guard vectors carried beyond n_eigen by the block solver */
+#define SUBSPACE_MIN_GUARD 8
+
+/*
+ * Block (simultaneous) subspace iteration. A d x p block Q, p = k plus
+ * guard vectors, is multiplied by the matrix with one GEMM per
+ * iteration. Rayleigh-Ritz on H = Q^T A Q rotates the block onto Ritz
+ * vectors. Householder QR then re-orthonormalizes A Q for the next
+ * step. All k vectors converge together at rate lambda_{p+1} / lambda_i,
+ * and no deflation error carries over from one pair to the next.
+ */
+int compute_eigen_subspace(const Matrix *cov_matrix, int n_eigen, double *eigenvalues,
+                           Matrix *eigenvectors, int max_iterations, double tolerance,
+                           EigenWorkspace *workspace) {
+    if (!cov_matrix || !eigenvalues || !eigenvectors) return -1;
+    
+    int d = cov_matrix->rows;
+    int k = n_eigen;
+    if (k <= 0 || k > d || eigenvectors->rows != d || eigenvectors->cols < k) {
+        print_error("Invalid eigensolver dimensions");
+        return -1;
+    }
+    
+    print_progress("Computing eigenvalues and eigenvectors (block subspace iteration)...");
+    
+    int p = k + ((k > SUBSPACE_MIN_GUARD) ? k : SUBSPACE_MIN_GUARD);
+    if (p > d) p = d;
+    
+    /* d x p x d is the largest of the per-iteration products */
+    EigenWorkspace *ws = workspace ? workspace : eigen_workspace_create();
+    if (!ws || eigen_workspace_reserve_block(ws, d, p) != 0 ||
+        eigen_workspace_reserve_dense(ws, p) != 0 ||
+        eigen_workspace_reserve_pack(ws, gemm_pack_size(d, p, d, NULL)) != 0) {
+        print_error("Failed to allocate subspace iteration workspace");
+        if (ws != workspace) eigen_workspace_free(ws);
+        return -1;
+    }
+    
+    Matrix *Q = ws->Q;          /* Orthonormal block */
+    Matrix *Z = ws->Z;          /* A Q */
+    Matrix *T = ws->T;          /* Rotation scratch */
+    Matrix *H = ws->H;          /* Q^T A Q */
+    Matrix *W = ws->W;          /* Ritz rotation */
+    double *theta = ws->theta;
+    
+    RandomState rng;
+    random_seed(&rng, 0x5CA1AB1EULL);
+    for (size_t i = 0; i < (size_t)d * Q->stride; i++) {
+        Q->values[i] = random_gaussian(&rng);
+    }
+    
+    int result = orthonormalize_columns(Q, ws->tau, ws->qr_row);
+    int iter = 0;
+    int converged = 0;
+    double max_residual = 0.0;
+    
+    while (result == 0) {
+        /* Z = A Q, H = Q^T Z */
+        memset(Z->values, 0, (size_t)d * Z->stride * sizeof(double));
+        memset(H->values, 0, (size_t)p * H->stride * sizeof(double));
+        gemm_driver(d, p, d, cov_matrix->values, cov_matrix->stride, 0,
+                    Q->values, Q->stride, Z->values, Z->stride, 0, ws->pack);
+        gemm_driver(p, p, d, Q->values, Q->stride, 1,
+                    Z->values, Z->stride, H->values, H->stride, 1, ws->pack);
+        
+        /* Rayleigh-Ritz: H = W diag(theta) W^T, rotate Q and Z by W */
+        symmetrize_upper(H->values, p, H->stride);
+        result = dense_eigen_solve(H, p, theta, W, ws);
+        if (result != 0) break;
+        
+        memset(T->values, 0, (size_t)d * T->stride * sizeof(double));
+        gemm_driver(d, p, p, Q->values, Q->stride, 0,
+                    W->values, W->stride, T->values, T->stride, 0, ws->pack);
+        matrix_copy(Q, T);
+        
+        memset(T->values, 0, (size_t)d * T->stride * sizeof(double));
+        gemm_driver(d, p, p, Z->values, Z->stride, 0,
+                    W->values, W->stride, T->values, T->stride, 0, ws->pack);
+        matrix_copy(Z, T);
+        
+        /* Residuals ||A q_i - theta_i q_i|| of the k leading Ritz pairs */
+        double scale = (fabs(theta[0]) > 0.0) ? fabs(theta[0]) : 1.0;
+        max_residual = 0.0;
+        for (int j = 0; j < k; j++) {
+            double sum = 0.0;
+            for (int i = 0; i < d; i++) {
+                double r = MATRIX_ROW(Z, i)[j] - theta[j] * MATRIX_ROW(Q, i)[j];
+                sum += r * r;
+            }
+            double res = sqrt(sum);
+            if (res > max_residual) max_residual = res;
+        }
+        
+        iter++;
+        converged = (max_residual <= tolerance * scale) || p == d;
+        if (converged || iter >= max_iterations) break;
+        
+        /* Next block: orthonormalized A Q */
+        matrix_copy(Q, Z);
+        result = orthonormalize_columns(Q, ws->tau, ws->qr_row);
+    }
+    
+    if (result == 0) {
+        for (int j = 0; j < k; j++) {
+            eigenvalues[j] = theta[j];
+            for (int i = 0; i < d; i++) {
+                MATRIX_ROW(eigenvectors, i)[j] = MATRIX_ROW(Q, i)[j];
+            }
+        }
+        printf("  Computed %d of %d eigenvalues (%d iteration%s, max residual %.3e)\n",
+               k, d, iter, (iter == 1) ? "" : "s", max_residual);
+        if (!converged) {
+            printf("  WARNING: subspace iteration stopped after %d iterations before reaching tolerance %.1e\n",
+                   iter, tolerance);
+        }
+    } else {
+        print_error("Subspace iteration failed");
+    }
+    
+    if (ws != workspace) eigen_workspace_free(ws);
+    
+    return result;
+}
+
+void sort_eigen(double *eigenvalues, Matrix *eigenvectors, int n) {
+    /* Simple bubble sort (sufficient for small n) */
+    for (int i = 0; i < n - 1; i++) {
+        for (int j = 0; j < n - i - 1; j++) {
+            if (eigenvalues[j] < eigenvalues[j + 1]) {
+                /* Swap eigenvalues */
+                double temp = eigenvalues[j];
+                eigenvalues[j] = eigenvalues[j + 1];
+                eigenvalues[j + 1] = temp;
+                
+                /* Swap eigenvectors */
+                for (int k = 0; k < eigenvectors->rows; k++) {
+                    temp = eigenvectors->data[k][j];
+                    eigenvectors->data[k][j] = eigenvectors->data[k][j + 1];
+                    eigenvectors->data[k][j + 1] = temp;
+                }
+            }
+        }
+    }
+}
+
+Matrix* project_data(const Matrix *data, const Matrix *eigenvectors, int k) {
+    if (!data || !eigenvectors || k <= 0 || k > eigenvectors->cols ||
+        data->cols != eigenvectors->rows) {
+        return NULL;
+    }
+    
+    print_progress("Projecting data onto principal components...");
+    
+    /* Project: X_pca = X * V[:, :k], reading the first k columns in place */
+    Matrix *projected = matrix_create(data->rows, k);
+    if (!projected) return NULL;
+    
+    if (gemm_driver(data->rows, k, data->cols, data->values, data->stride, 0,
+                    eigenvectors->values, eigenvectors->stride,
+                    projected->values, projected->stride, 0, NULL) != 0) {
+        print_error("Failed to allocate GEMM packing buffers");
+        matrix_free(projected);
+        return NULL;
+    }
+    
+    printf("  Projected to %d dimensions\n", k);
+    
+    return projected;
+}
+
+/*
+ * Products with the implicitly centered data Xc = X - 1 m^T. Each task
+ * centers its rows block by block into scratch and runs the GEMM on the
+ * block, so large feature offsets never enter the products and the
+ * input is not modified.
+ */
+
+/* Rows per block when centering inside a product */
+#define PROJECT_BLOCK_ROWS 256
+
+typedef struct {
+    const Matrix *data;
+    const double *mean;
+    const double *B;            /* Right operand: d x l (forward) or n x l (transposed) */
+    int ldb;
+    int l;
+    double *out;                /* n x l (forward) or private d x l partial (transposed) */
+    int ldo;
+    int row_start;
+    int row_end;
+    Matrix *block;              /* Centering scratch (up to PROJECT_BLOCK_ROWS x d) */
+    double *pack;               /* GEMM packing buffer of one block product */
+    int status;
+} CenteredProductTask;
+
+/* Center rows [r0, r0 + b) of data into block */
+static void center_rows(const Matrix *data, const double *mean, int r0, int b,
+                        Matrix *block) {
+    for (int i = 0; i < b; i++) {
+        const double *row = MATRIX_ROW(data, r0 + i);
+        double *out = MATRIX_ROW(block, i);
+        for (int j = 0; j < data->cols; j++) {
+            out[j] = row[j] - mean[j];
+        }
+    }
+}
+
+static void centered_product_task(void *arg, int transposed) {
+    CenteredProductTask *t = (CenteredProductTask*)arg;
+    int d = t->data->cols;
+    int rows = t->row_end - t->row_start;
+    t->status = 0;
+    if (rows <= 0) return;
+    
+    Matrix *block = t->block;
+    int block_rows = block->rows;
+    
+    for (int r0 = t->row_start; r0 < t->row_end && t->status == 0; r0 += block_rows) {
+        int b = (t->row_end - r0 < block_rows) ? t->row_end - r0 : block_rows;
+        center_rows(t->data, t->mean, r0, b, block);
+        
+        if (transposed) {
+            /* out (d x l) += block^T * B[r0:r0+b] */
+            t->status = gemm_driver(d, t->l, b, block->values, block->stride, 1,
+                                    t->B + (size_t)r0 * t->ldb, t->ldb,
+                                    t->out, t->ldo, 0, t->pack);
+        } else {
+            /* out[r0:r0+b] += block * B */
+            t->status = gemm_driver(b, t->l, d, block->values, block->stride, 0,
+                                    t->B, t->ldb, t->out + (size_t)r0 * t->ldo,
+                                    t->ldo, 0, t->pack);
+        }
+    }
+}
+
+static void centered_product_forward_task(void *arg) {
+    centered_product_task(arg, 0);
+}
+
+static void centered_product_transposed_task(void *arg) {
+    centered_product_task(arg, 1);
+}
+
+/*
+ * out = Xc * B (transposed = 0; B is d x l, out is n x l) or
+ * out = Xc^T * B (transposed = 1; B is n x l, out is d x l).
+ * out is overwritten. Rows of X are split across threads; in the
+ * transposed case each thread accumulates a private partial.
+ */
+static int centered_product(const Matrix *data, const double *mean, const Matrix *B,
+                            Matrix *out, int transposed, int n_threads, PCAArena *arena) {
+    int d = data->cols;
+    int l = B->cols;
+    
+    n_threads = row_thread_count(n_threads, data->rows);
+    
+    size_t mark = pca_arena_mark(arena);
+    CenteredProductTask *tasks = (CenteredProductTask*)scratch_calloc(arena, n_threads,
+                                                                      sizeof(CenteredProductTask));
+    if (!tasks) return -1;
+    
+    memset(out->values, 0, (size_t)out->rows * out->stride * sizeof(double));
+    
+    int ok = 1;
+    for (int t = 0; t < n_threads; t++) {
+        tasks[t].data = data;
+        tasks[t].mean = mean;
+        tasks[t].B = B->values;
+        tasks[t].ldb = B->stride;
+        tasks[t].l = l;
+        tasks[t].row_start = (int)((long long)data->rows * t / n_threads);
+        tasks[t].row_end = (int)((long long)data->rows * (t + 1) / n_threads);
+        tasks[t].ldo = out->stride;
+        if (!transposed || t == 0) {
+            tasks[t].out = out->values;
+        } else if (ok) {
+            tasks[t].out = (double*)scratch_calloc(arena, (size_t)d * out->stride, sizeof(double));
+            if (!tasks[t].out) ok = 0;
+        }
+        
+        int rows = tasks[t].row_end - tasks[t].row_start;
+        if (rows > 0 && ok) {
+            int block_rows = (rows < PROJECT_BLOCK_ROWS) ? rows : PROJECT_BLOCK_ROWS;
+            size_t pack_size = transposed ? gemm_pack_size(d, l, block_rows, NULL)
+                                          : gemm_pack_size(block_rows, l, d, NULL);
+            tasks[t].block = scratch_matrix(arena, block_rows, d);
+            tasks[t].pack = (double*)scratch_alloc(arena, pack_size * sizeof(double));
+            if (!tasks[t].block || !tasks[t].pack) ok = 0;
+        }
+    }
+    
+    if (ok) {
+        parallel_run(n_threads, transposed ? centered_product_transposed_task
+                                           : centered_product_forward_task,
+                     tasks, sizeof(CenteredProductTask));
+        for (int t = 0; t < n_threads; t++) {
+            if (tasks[t].status != 0) ok = 0;
+        }
+    }
+    
+    if (transposed && ok) {
+        for (int t = 1; t < n_threads; t++) {
+            size_t count = (size_t)d * out->stride;
+            for (size_t i = 0; i < count; i++) {
+                out->values[i] += tasks[t].out[i];
+            }
+        }
+    }
+    
+    for (int t = 0; t < n_threads; t++) {
+        if (transposed && t > 0) scratch_free(arena, tasks[t].out);
+        matrix_free(tasks[t].block);
+        scratch_free(arena, tasks[t].pack);
+    }
+    scratch_free(arena, tasks);
+    pca_arena_release(arena, mark);
+    
+    return ok ? 0 : -1;
+}
+
+/* Rows absorbed per TSQR step (raised to d so stacking two R factors fits) */
+#define TSQR_BLOCK_ROWS 256
+
+/* Per-thread state for the TSQR reduction */
+typedef struct {
+    const Matrix *data;
+    const double *mean;
+    int row_start;
+    int row_end;
+    Matrix *stack;      /* (d + block) x d: running R on top, incoming rows below */
+    double *tau;
+    double *w;          /* Reflector row of the QR */
+    int status;
+} TsqrTask;
+
+/*
+ * QR of the top d + count rows of the stack, keeping only R in the top
+ * d x d block (the reflectors below its diagonal are cleared, and the
+ * rows under it are free for the next block).
+ */
+static int tsqr_reduce(Matrix *stack, int count, double *tau, double *w) {
+    int d = stack->cols;
+    int capacity = stack->rows;
+    
+    stack->rows = d + count;
+    int result = householder_qr(stack, tau, w);
+    stack->rows = capacity;
+    
+    for (int i = 1; i < d; i++) {
+        memset(MATRIX_ROW(stack, i), 0, i * sizeof(double));
+    }
+    return result;
+}
+
+static void tsqr_task(void *arg) {
+    TsqrTask *t = (TsqrTask*)arg;
+    int d = t->data->cols;
+    int block = t->stack->rows - d;
+    
+    for (int r0 = t->row_start; r0 < t->row_end; r0 += block) {
+        int count = (t->row_end - r0 < block) ? t->row_end - r0 : block;
+        for (int i = 0; i < count; i++) {
+            const double *row = MATRIX_ROW(t->data, r0 + i);
+            double *dst = MATRIX_ROW(t->stack, d + i);
+            for (int j = 0; j < d; j++) {
+                dst[j] = row[j] - t->mean[j];
+            }
+        }
+        if (tsqr_reduce(t->stack, count, t->tau, t->w) != 0) {
+            t->status = -1;
+            return;
+        }
+    }
+    t->status = 0;
+}
+
+/*
+ * Store the k largest singular triplets from a row-wise Jacobi SVD: row i
+ * of B is the right singular vector for sigma[i]. The covariance
+ * eigenvalues are sigma^2 / (n - 1).
+ */
+static void store_leading_singular(const Matrix *B, const double *sigma, int *order,
+                                   int l, int k, int n,
+                                   double *eigenvalues, Matrix *eigenvectors) {
+    int d = B->cols;
+    double scale = 1.0 / ((n > 1) ? (n - 1) : 1);
+    
+    for (int i = 0; i < l; i++) {
+        order[i] = i;
+    }
+    for (int i = 0; i < k; i++) {
+        int best = i;
+        for (int j = i + 1; j < l; j++) {
+            if (sigma[order[j]] > sigma[order[best]]) best = j;
+        }
+        int tmp = order[i];
+        order[i] = order[best];
+        order[best] = tmp;
+        
+        eigenvalues[i] = sigma[order[i]] * sigma[order[i]] * scale;
+        const double *axis = MATRIX_ROW(B, order[i]);
+        for (int r = 0; r < d; r++) {
+            MATRIX_ROW(eigenvectors, r)[i] = axis[r];
+        }
+    }
+}
+
+/*
+ * SVD of the centered data through a tall-skinny QR. Each thread streams
+ * its rows in blocks, folding every block into a running d x d R with
+ * Householder QR. The per-thread R factors are then stacked pairwise and
+ * reduced again. Xc = Q R, so the right singular vectors of the small R
+ * (one-sided Jacobi) are the principal axes. The covariance is never
+ * formed, so the condition number is not squared.
+ */
+int tsqr_pca(const Matrix *data, const double *mean, int n_components, int n_threads,
+             double *eigenvalues, Matrix *eigenvectors, PCAArena *arena) {
+    if (!data || !mean || !eigenvalues || !eigenvectors) return -1;
+    
+    int n = data->rows;
+    int d = data->cols;
+    int k = n_components;
+    if (k <= 0 || k > d || eigenvectors->rows != d || eigenvectors->cols < k) {
+        print_error("Invalid SVD dimensions");
+        return -1;
+    }
+    
+    print_progress("Computing SVD of the centered data (TSQR + Jacobi)...");
+    
+    n_threads = row_thread_count(n_threads, n);
+    
+    int block = (d > TSQR_BLOCK_ROWS) ? d : TSQR_BLOCK_ROWS;
+    
+    size_t mark = pca_arena_mark(arena);
+    TsqrTask *tasks = (TsqrTask*)scratch_calloc(arena, n_threads, sizeof(TsqrTask));
+    double *sigma = (double*)scratch_alloc(arena, d * sizeof(double));
+    int *order = (int*)scratch_alloc(arena, d * sizeof(int));
+    if (!tasks || !sigma || !order) {
+        scratch_free(arena, tasks);
+        scratch_free(arena, sigma);
+        scratch_free(arena, order);
+        pca_arena_release(arena, mark);
+        return -1;
+    }
+    
+    int ok = 1;
+    for (int t = 0; t < n_threads && ok; t++) {
+        tasks[t].data = data;
+        tasks[t].mean = mean;
+        tasks[t].row_start = (int)((long long)n * t / n_threads);
+        tasks[t].row_end = (int)((long long)n * (t + 1) / n_threads);
+        tasks[t].stack = scratch_matrix(arena, d + block, d);
+        tasks[t].tau = (double*)scratch_alloc(arena, d * sizeof(double));
+        tasks[t].w = (double*)scratch_alloc(arena, d * sizeof(double));
+        if (!tasks[t].stack || !tasks[t].tau || !tasks[t].w) ok = 0;
+    }
+    
+    if (ok) {
+        parallel_run(n_threads, tsqr_task, tasks, sizeof(TsqrTask));
+        for (int t = 0; t < n_threads; t++) {
+            if (tasks[t].status != 0) ok = 0;
+        }
+    }
+    
+    /* Fold the per-thread R factors into thread 0's: QR of [R_0; R_t] */
+    Matrix *stack = ok ? tasks[0].stack : NULL;
+    for (int t = 1; t < n_threads && ok; t++) {
+        for (int i = 0; i < d; i++) {
+            memcpy(MATRIX_ROW(stack, d + i), MATRIX_ROW(tasks[t].stack, i), d * sizeof(double));
+        }
+        if (tsqr_reduce(stack, d, tasks[0].tau, tasks[0].w) != 0) ok = 0;
+    }
+    
+    int sweeps = -1;
+    if (ok) {
+        /* R's rows become sigma_i v_i^T after the Jacobi rotations */
+        stack->rows = d;
+        sweeps = jacobi_svd_rows(stack, sigma);
+        if (sweeps < 0) {
+            print_error("Jacobi SVD did not converge");
+            ok = 0;
+        } else {
+            store_leading_singular(stack, sigma, order, d, k, n, eigenvalues, eigenvectors);
+        }
+        stack->rows = d + block;
+    }
+    
+    for (int t = 0; t < n_threads; t++) {
+        matrix_free(tasks[t].stack);
+        scratch_free(arena, tasks[t].tau);
+        scratch_free(arena, tasks[t].w);
+    }
+    scratch_free(arena, tasks);
+    scratch_free(arena, sigma);
+    scratch_free(arena, order);
+    pca_arena_release(arena, mark);
+    
+    if (!ok) {
+        print_error("SVD of the centered data failed");
+        return -1;
+    }
+    
+    printf("  R factor: %d x %d (%d thread%s, %d Jacobi sweep%s)\n", d, d,
+           n_threads, (n_threads == 1) ? "" : "s", sweeps, (sweeps == 1) ? "" : "s");
+    printf("  Computed %d of %d components\n", k, d);
+    
+    return 0;
+}
+
+/*
+ * Randomized SVD (Halko, Martinsson & Tropp): sketch the range of Xc with
+ * a Gaussian test matrix, refine it with subspace (power) iterations that
+ * re-orthonormalize with Householder QR after every product, then take
+ * the exact SVD of the small projection B = Q^T Xc with one-sided Jacobi.
+ * The right singular vectors of B are the principal axes and
+ * sigma^2 / (n - 1) are the eigenvalues of the covariance.
+ */
+int randomized_pca(const Matrix *data, const double *mean, int n_components,
+                   int oversample, int power_iterations, int n_threads,
+                   double *eigenvalues, Matrix *eigenvectors, PCAArena *arena) {
+    if (!data || !mean || !eigenvalues || !eigenvectors) return -1;
+    
+    int n = data->rows;
+    int d = data->cols;
+    int k = n_components;
+    if (k <= 0 || k > d || eigenvectors->rows != d || eigenvectors->cols < k) {
+        print_error("Invalid randomized SVD dimensions");
+        return -1;
+    }
+    
+    int l = k + ((oversample > 0) ? oversample : 0);
+    if (l > d) l = d;
+    if (l > n) l = n;
+    if (l < k) {
+        print_error("Randomized SVD needs at least n_components samples");
+        return -1;
+    }
+    
+    print_progress("Computing randomized SVD...");
+    printf("  Sketch size %d, %d power iteration%s\n",
+           l, power_iterations, (power_iterations == 1) ? "" : "s");
+    
+    size_t mark = pca_arena_mark(arena);
+    Matrix *omega = scratch_matrix(arena, d, l);     /* Test matrix, then Xc^T Q */
+    Matrix *Y = scratch_matrix(arena, n, l);         /* Range sketch Xc * omega */
+    Matrix *B = scratch_matrix(arena, l, d);         /* Q^T Xc */
+    double *sigma = (double*)scratch_alloc(arena, l * sizeof(double));
+    int *order = (int*)scratch_alloc(arena, l * sizeof(int));
+    double *tau = (double*)scratch_alloc(arena, l * sizeof(double));
+    double *w = (double*)scratch_alloc(arena, l * sizeof(double));
+    int result = -1;
+    
+    if (omega && Y && B && sigma && order && tau && w) {
+        RandomState rng;
+        random_seed(&rng, 0xC0FFEEULL);
+        size_t count = (size_t)d * omega->stride;
+        for (size_t i = 0; i < count; i++) {
+            omega->values[i] = random_gaussian(&rng);
+        }
+        
+        /* Y = Xc omega, Q = qr(Y); then (Xc Xc^T)^q refinement */
+        result = centered_product(data, mean, omega, Y, 0, n_threads, arena);
+        if (result == 0) result = orthonormalize_columns(Y, tau, w);
+        for (int it = 0; it < power_iterations && result == 0; it++) {
+            result = centered_product(data, mean, Y, omega, 1, n_threads, arena);
+            if (result == 0) result = orthonormalize_columns(omega, tau, w);
+            if (result == 0) result = centered_product(data, mean, omega, Y, 0, n_threads, arena);
+            if (result == 0) result = orthonormalize_columns(Y, tau, w);
+        }
+        
+        /* B = Q^T Xc = (Xc^T Q)^T */
+        if (result == 0) result = centered_product(data, mean, Y, omega, 1, n_threads, arena);
+        if (result == 0) {
+            for (int i = 0; i < d; i++) {
+                const double *row = MATRIX_ROW(omega, i);
+                for (int j = 0; j < l; j++) {
+                    MATRIX_ROW(B, j)[i] = row[j];
+                }
+            }
+            if (jacobi_svd_rows(B, sigma) < 0) {
+                print_error("Jacobi SVD did not converge");
+                result = -1;
             }
         }
-        
-        free(v);
     }
     
-    matrix_free(A);
+    if (result == 0) {
+        /* Largest singular values first */
+        store_leading_singular(B, sigma, order, l, k, n, eigenvalues, eigenvectors);
+        printf("  Computed %d of %d components\n", k, d);
+    } else {
+        print_error("Randomized SVD failed");
+    }
+    
+    matrix_free(omega);
+    matrix_free(Y);
+    matrix_free(B);
+    scratch_free(arena, sigma);
+    scratch_free(arena, order);
+    scratch_free(arena, tau);
+    scratch_free(arena, w);
+    pca_arena_release(arena, mark);
+    
+    return result;
+}
+
+PCAOptions pca_default_options(void) {
+    PCAOptions options;
+    options.n_threads = 0;
+    options.eigen_solver = PCA_EIGEN_SUBSPACE;
+    options.max_iterations = 1000;
+    options.tolerance = 1e-10;
+    options.matrix_free = 0;
+    options.solver = PCA_SOLVER_COVARIANCE;
+    options.oversample = 10;
+    options.power_iterations = 2;
+    options.workspace = NULL;
+    options.arena = NULL;
+    return options;
+}
+
+static const char *solver_names[] = { "covariance", "randomized", "svd" };
+
+const char* pca_solver_name(PCASolver solver) {
+    if ((int)solver < 0 || (int)solver >= (int)(sizeof(solver_names) / sizeof(solver_names[0]))) {
+        return "unknown";
+    }
+    return solver_names[solver];
+}
+
+int pca_solver_parse(const char *name, PCASolver *solver) {
+    if (!name || !solver) return -1;
+    
+    for (int i = 0; i < (int)(sizeof(solver_names) / sizeof(solver_names[0])); i++) {
+        if (strcmp(name, solver_names[i]) == 0) {
+            *solver = (PCASolver)i;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static const char *eigen_solver_names[] = { "power", "dense", "lanczos", "subspace" };
+
+const char* pca_eigen_solver_name(PCAEigenSolver solver) {
+    if ((int)solver < 0 || (int)solver >= (int)(sizeof(eigen_solver_names) / sizeof(eigen_solver_names[0]))) {
+        return "unknown";
+    }
+    return eigen_solver_names[solver];
+}
+
+int pca_eigen_solver_parse(const char *name, PCAEigenSolver *solver) {
+    if (!name || !solver) return -1;
+    
+    for (int i = 0; i < (int)(sizeof(eigen_solver_names) / sizeof(eigen_solver_names[0])); i++) {
+        if (strcmp(name, eigen_solver_names[i]) == 0) {
+            *solver = (PCAEigenSolver)i;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/* Eigen workspace of one fit: the caller's, else arena_ws backed by the
+ * arena (released by the caller), else NULL for a per-call heap workspace */
+static EigenWorkspace* fit_workspace(const PCAOptions *opts, EigenWorkspace *arena_ws) {
+    if (opts->workspace || !opts->arena) return opts->workspace;
+    
+    memset(arena_ws, 0, sizeof(*arena_ws));
+    arena_ws->arena = opts->arena;
+    return arena_ws;
+}
+
+/* Run the eigen backend selected in the options for the top k pairs */
+static int solve_eigen(const Matrix *cov, int k, const PCAOptions *opts,
+                       double *eigenvalues, Matrix *eigenvectors) {
+    EigenWorkspace arena_ws;
+    size_t mark = pca_arena_mark(opts->arena);
+    EigenWorkspace *ws = fit_workspace(opts, &arena_ws);
+    
+    int result = -1;
+    switch (opts->eigen_solver) {
+        case PCA_EIGEN_POWER:
+            result = compute_eigen_topk(cov, k, eigenvalues, eigenvectors,
+                                        opts->max_iterations, opts->tolerance, ws);
+            break;
+        case PCA_EIGEN_DENSE:
+            result = compute_eigen_dense(cov, k, eigenvalues, eigenvectors, ws);
+            break;
+        case PCA_EIGEN_LANCZOS: {
+            LinearOperator op;
+            linear_operator_from_matrix(&op, cov);
+            result = compute_eigen_lanczos(&op, k, eigenvalues, eigenvectors, NULL,
+                                           opts->max_iterations, opts->tolerance, ws);
+            break;
+        }
+        case PCA_EIGEN_SUBSPACE:
+            result = compute_eigen_subspace(cov, k, eigenvalues, eigenvectors,
+                                            opts->max_iterations, opts->tolerance, ws);
+            break;
+        default:
+            print_error("Unknown eigen solver");
+            break;
+    }
+    
+    if (ws == &arena_ws) pca_arena_release(opts->arena, mark);
+    return result;
+}
+
+/* Covariance path: fused mean + covariance, then the selected eigen backend */
+static int fit_covariance(const Matrix *data, int k, const PCAOptions *opts,
+                          PCAModel *model) {
+    model->mean = (double*)malloc(data->cols * sizeof(double));
+    if (!model->mean) return -1;
+    
+    /* Mean and covariance in one pass (data is not modified) */
+    Matrix *cov = NULL;
+    if (mean_covariance_pass(data, opts->n_threads, opts->arena, model->mean, &cov) != 0) {
+        return -1;
+    }
+    
+    /* Total variance is the trace, so only the top k pairs are needed */
+    model->total_variance = matrix_trace(cov);
+    
+    int result = solve_eigen(cov, k, opts, model->eigenvalues, model->eigenvectors);
+    matrix_free(cov);
+    
+    return result;
+}
+
+/* Mean (kept in the model) and total variance (trace of the covariance) */
+static int fit_mean_variance(const Matrix *data, PCAArena *arena, PCAModel *model) {
+    int d = data->cols;
+    
+    model->mean = (double*)malloc(d * sizeof(double));
+    size_t mark = pca_arena_mark(arena);
+    double *variance = (double*)scratch_alloc(arena, d * sizeof(double));
+    if (!model->mean || !variance) {
+        scratch_free(arena, variance);
+        pca_arena_release(arena, mark);
+        return -1;
+    }
+    
+    compute_mean_variance(data, model->mean, variance);
     
-    printf("  Computed %d eigenvalues\n", n);
+    /* Trace of the covariance = sum of the feature variances */
+    model->total_variance = 0.0;
+    for (int j = 0; j < d; j++) {
+        model->total_variance += variance[j];
+    }
+    scratch_free(arena, variance);
+    pca_arena_release(arena, mark);
     
     return 0;
 }
 
-void sort_eigen(double *eigenvalues, Matrix *eigenvectors, int n) {
-    /* Simple bubble sort (sufficient for small n) */
-    for (int i = 0; i < n - 1; i++) {
-        for (int j = 0; j < n - i - 1; j++) {
-            if (eigenvalues[j] < eigenvalues[j + 1]) {
-                /* Swap eigenvalues */
-                double temp = eigenvalues[j];
-                eigenvalues[j] = eigenvalues[j + 1];
-                eigenvalues[j + 1] = temp;
-                
-                /* Swap eigenvectors */
-                for (int k = 0; k < eigenvectors->rows; k++) {
-                    temp = eigenvectors->data[k][j];
-                    eigenvectors->data[k][j] = eigenvectors->data[k][j + 1];
-                    eigenvectors->data[k][j + 1] = temp;
+/* Matrix-free path: the covariance is only ever applied as X^T(X v) */
+static int fit_matrix_free(const Matrix *data, int k, const PCAOptions *opts,
+                           PCAModel *model) {
+    print_progress("Computing mean and variance (matrix-free covariance)...");
+    
+    if (fit_mean_variance(data, opts->arena, model) != 0) return -1;
+    
+    LinearOperator op;
+    if (linear_operator_covariance(&op, data, model->mean, opts->n_threads) != 0) {
+        print_error("Failed to create covariance operator");
+        return -1;
+    }
+    
+    if (opts->eigen_solver != PCA_EIGEN_LANCZOS) {
+        printf("  Matrix-free covariance uses the lanczos eigen solver\n");
+    }
+    
+    EigenWorkspace arena_ws;
+    size_t mark = pca_arena_mark(opts->arena);
+    EigenWorkspace *ws = fit_workspace(opts, &arena_ws);
+    int result = compute_eigen_lanczos(&op, k, model->eigenvalues, model->eigenvectors,
+                                       NULL, opts->max_iterations, opts->tolerance, ws);
+    if (ws == &arena_ws) pca_arena_release(opts->arena, mark);
+    linear_operator_release(&op);
+    
+    return result;
+}
+
+/*
+ * Gram path for n < d: Xc Xc^T / (n - 1) has the same nonzero
+ * eigenvalues as the covariance. Each eigenvector u maps back to the
+ * principal axis Xc^T u, with norm sqrt((n - 1) lambda).
+ */
+static int fit_gram(const Matrix *data, int k, const PCAOptions *opts,
+                    PCAModel *model) {
+    int n = data->rows;
+    int d = data->cols;
+    
+    print_progress("Computing mean and variance...");
+    
+    if (fit_mean_variance(data, opts->arena, model) != 0) return -1;
+    
+    Matrix *gram = gram_matrix(data, model->mean, opts->arena);
+    if (!gram) return -1;
+    
+    Matrix *U = scratch_matrix(opts->arena, n, k);
+    if (!U) {
+        matrix_free(gram);
+        return -1;
+    }
+    
+    int result = solve_eigen(gram, k, opts, model->eigenvalues, U);
+    matrix_free(gram);
+    
+    /* Principal axes V = Xc^T U, normalized column by column */
+    if (result == 0) {
+        print_progress("Mapping Gram eigenvectors back to feature space...");
+        result = centered_product(data, model->mean, U, model->eigenvectors, 1,
+                                  opts->n_threads, opts->arena);
+    }
+    if (result == 0) {
+        for (int j = 0; j < k; j++) {
+            double norm = 0.0;
+            for (int i = 0; i < d; i++) {
+                double v = MATRIX_ROW(model->eigenvectors, i)[j];
+                norm += v * v;
+            }
+            norm = sqrt(norm);
+            if (norm > 0.0) {
+                for (int i = 0; i < d; i++) {
+                    MATRIX_ROW(model->eigenvectors, i)[j] /= norm;
                 }
             }
         }
     }
+    matrix_free(U);
+    
+    return result;
 }
 
-Matrix* project_data(const Matrix *data, const Matrix *eigenvectors, int k) {
-    if (!data || !eigenvectors || k <= 0) return NULL;
+/* SVD path: TSQR of the centered data, then Jacobi SVD of R */
+static int fit_svd(const Matrix *data, int k, const PCAOptions *opts,
+                   PCAModel *model) {
+    print_progress("Computing mean and variance...");
     
-    print_progress("Projecting data onto principal components...");
+    if (fit_mean_variance(data, opts->arena, model) != 0) return -1;
+    
+    return tsqr_pca(data, model->mean, k, opts->n_threads,
+                    model->eigenvalues, model->eigenvectors, opts->arena);
+}
+
+/* Randomized path: sketch + power iterations on the centered data */
+static int fit_randomized(const Matrix *data, int k, const PCAOptions *opts,
+                          PCAModel *model) {
+    print_progress("Computing mean and variance...");
     
-    /* Create matrix with first k eigenvectors */
-    Matrix *components = matrix_create(eigenvectors->rows, k);
-    if (!components) return NULL;
+    if (fit_mean_variance(data, opts->arena, model) != 0) return -1;
     
-    for (int i = 0; i < eigenvectors->rows; i++) {
-        for (int j = 0; j < k; j++) {
-            components->data[i][j] = eigenvectors->data[i][j];
+    return randomized_pca(data, model->mean, k, opts->oversample,
+                          opts->power_iterations, opts->n_threads,
+                          model->eigenvalues, model->eigenvectors, opts->arena);
+}
+
+/* Fewer samples than features: eigendecompose the n x n Gram matrix */
+static int use_gram_path(int n, int d, int k, const PCAOptions *opts) {
+    return opts->solver == PCA_SOLVER_COVARIANCE && !opts->matrix_free &&
+           n < d && k < n;
+}
+
+/* Arena bytes of the dense-solve buffers for a dim x dim matrix */
+static size_t dense_scratch_bytes(int dim) {
+    return 2 * arena_matrix_bytes(dim, dim) + 2 * arena_round(dim * sizeof(double)) +
+           arena_round(dim * sizeof(int));
+}
+
+/* Arena bytes of the GEMM packing buffer for an m x n x k product */
+static size_t pack_scratch_bytes(int m, int n, int k) {
+    return arena_round(gemm_pack_size(m, n, k, NULL) * sizeof(double));
+}
+
+/* Arena bytes an eigen backend takes from the arena for a dim x dim problem */
+static size_t eigen_scratch_bytes(int dim, int k, const PCAOptions *opts) {
+    if (opts->workspace) return 0;
+    
+    switch (opts->eigen_solver) {
+        case PCA_EIGEN_POWER:
+            return arena_matrix_bytes(dim, dim) + 2 * arena_round(dim * sizeof(double));
+        case PCA_EIGEN_DENSE:
+            return dense_scratch_bytes(dim);
+        case PCA_EIGEN_LANCZOS: {
+            int m = k + ((k > LANCZOS_MIN_EXTRA) ? k : LANCZOS_MIN_EXTRA);
+            if (m > dim) m = dim;
+            return 2 * arena_matrix_bytes(m, dim) + 3 * arena_matrix_bytes(m, m) +
+                   3 * arena_round(m * sizeof(double)) + 2 * arena_round(dim * sizeof(double)) +
+                   dense_scratch_bytes(m) + pack_scratch_bytes(m, dim, m);
+        }
+        case PCA_EIGEN_SUBSPACE: {
+            int p = k + ((k > SUBSPACE_MIN_GUARD) ? k : SUBSPACE_MIN_GUARD);
+            if (p > dim) p = dim;
+            return 3 * arena_matrix_bytes(dim, p) + 2 * arena_matrix_bytes(p, p) +
+                   3 * arena_round(p * sizeof(double)) + dense_scratch_bytes(p) +
+                   pack_scratch_bytes(dim, p, dim);
         }
+        default:
+            return 0;
     }
+}
+
+/* Arena bytes of one centered_product call with an l-column right operand */
+static size_t centered_product_scratch_bytes(int n, int d, int l, int transposed,
+                                             int n_threads) {
+    n_threads = row_thread_count(n_threads, n);
+    size_t bytes = arena_round(n_threads * sizeof(CenteredProductTask));
     
-    /* Project: X_pca = X * components */
-    Matrix *projected = matrix_multiply(data, components);
-    matrix_free(components);
+    for (int t = 0; t < n_threads; t++) {
+        int rows = (int)((long long)n * (t + 1) / n_threads) - (int)((long long)n * t / n_threads);
+        if (transposed && t > 0) bytes += arena_round((size_t)d * l * sizeof(double));
+        if (rows > 0) {
+            int block_rows = (rows < PROJECT_BLOCK_ROWS) ? rows : PROJECT_BLOCK_ROWS;
+            bytes += arena_matrix_bytes(block_rows, d) +
+                     (transposed ? pack_scratch_bytes(d, l, block_rows)
+                                 : pack_scratch_bytes(block_rows, l, d));
+        }
+    }
+    return bytes;
+}
+
+size_t pca_scratch_bytes(int n_samples, int n_features, int n_components,
+                         const PCAOptions *options) {
+    PCAOptions opts = options ? *options : pca_default_options();
+    int n = n_samples;
+    int d = n_features;
+    int k = n_components;
+    if (n <= 0 || d <= 0 || k <= 0 || k > d) return 0;
     
-    if (projected) {
-        printf("  Projected to %d dimensions\n", k);
+    size_t variance = arena_round(d * sizeof(double));
+    size_t fit;
+    
+    if (opts.solver == PCA_SOLVER_RANDOMIZED) {
+        int l = k + ((opts.oversample > 0) ? opts.oversample : 0);
+        if (l > d) l = d;
+        if (l > n) l = n;
+        size_t product = centered_product_scratch_bytes(n, d, l, 0, opts.n_threads);
+        size_t product_t = centered_product_scratch_bytes(n, d, l, 1, opts.n_threads);
+        fit = arena_matrix_bytes(d, l) + arena_matrix_bytes(n, l) + arena_matrix_bytes(l, d) +
+              3 * arena_round(l * sizeof(double)) + arena_round(l * sizeof(int)) +
+              ((product > product_t) ? product : product_t);
+    } else if (opts.solver == PCA_SOLVER_SVD) {
+        int n_threads = row_thread_count(opts.n_threads, n);
+        int block = (d > TSQR_BLOCK_ROWS) ? d : TSQR_BLOCK_ROWS;
+        fit = arena_round(n_threads * sizeof(TsqrTask)) + arena_round(d * sizeof(double)) +
+              arena_round(d * sizeof(int)) +
+              n_threads * (arena_matrix_bytes(d + block, d) + 2 * arena_round(d * sizeof(double)));
+    } else if (opts.matrix_free) {
+        PCAOptions lanczos = opts;
+        lanczos.eigen_solver = PCA_EIGEN_LANCZOS;
+        fit = eigen_scratch_bytes(d, k, &lanczos);
+    } else if (use_gram_path(n, d, k, &opts)) {
+        int slab_cols = (d < GRAM_SLAB_COLS) ? d : GRAM_SLAB_COLS;
+        size_t eigen = eigen_scratch_bytes(n, k, &opts);
+        size_t product = centered_product_scratch_bytes(n, d, k, 1, opts.n_threads);
+        size_t after_gram = arena_matrix_bytes(n, k) + ((eigen > product) ? eigen : product);
+        size_t slab = arena_matrix_bytes(slab_cols, n) + pack_scratch_bytes(n, n, slab_cols);
+        fit = arena_matrix_bytes(n, n) + ((slab > after_gram) ? slab : after_gram);
+    } else {
+        int n_threads = row_thread_count(opts.n_threads, n);
+        size_t accumulator = arena_round(sizeof(CovAccumulator)) +
+                             2 * arena_round(d * sizeof(double)) +
+                             arena_matrix_bytes(d, d) +
+                             arena_matrix_bytes(cov_block_rows(d), d) +
+                             pack_scratch_bytes(d, d, cov_block_rows(d));
+        fit = arena_round(n_threads * sizeof(MeanCovarianceTask)) + n_threads * accumulator +
+              eigen_scratch_bytes(d, k, &opts);
+        variance = 0;
     }
+    if (fit < variance) fit = variance;
     
-    return projected;
+    /* pca_transform only needs one centering block and its packing buffer */
+    int block_rows = (n < PROJECT_BLOCK_ROWS) ? n : PROJECT_BLOCK_ROWS;
+    size_t transform = arena_matrix_bytes(block_rows, d) + pack_scratch_bytes(block_rows, k, d);
+    
+    return (fit > transform) ? fit : transform;
+}
+
+/* Model with room for k eigenpairs of d features */
+static PCAModel* model_create(int d, int k) {
+    PCAModel *model = (PCAModel*)calloc(1, sizeof(PCAModel));
+    if (!model) {
+        print_error("Failed to allocate PCA model");
+        return NULL;
+    }
+    
+    model->n_components = k;
+    model->eigenvalues = (double*)malloc(k * sizeof(double));
+    model->eigenvectors = matrix_create(d, k);
+    
+    if (!model->eigenvalues || !model->eigenvectors) {
+        pca_free(model);
+        return NULL;
+    }
+    return model;
+}
+
+/* Sort the eigenpairs, compute the explained variance and report the fit */
+static void model_finish(PCAModel *model) {
+    int n_components = model->n_components;
+    
+    print_progress("Sorting by eigenvalues (descending)...");
+    sort_eigen(model->eigenvalues, model->eigenvectors, n_components);
+    
+    /* Calculate explained variance */
+    double explained_variance = 0.0;
+    for (int i = 0; i < n_components; i++) {
+        explained_variance += model->eigenvalues[i];
+    }
+    
+    model->explained_variance_ratio = (model->total_variance > 0.0)
+        ? explained_variance / model->total_variance : 0.0;
+    
+    printf("\n========================================\n");
+    printf("PCA Model Training Complete\n");
+    printf("========================================\n");
+    printf("Explained variance ratio: %.4f (%.2f%%)\n", 
+           model->explained_variance_ratio, 
+           model->explained_variance_ratio * 100);
+    printf("\nTop eigenvalues:\n");
+    for (int i = 0; i < (n_components < 5 ? n_components : 5); i++) {
+        printf("  PC%d: %.6f\n", i + 1, model->eigenvalues[i]);
+    }
+    printf("\n");
+}
+
+PCAModel* pca_fit(const Matrix *data, int n_components) {
+    return pca_fit_with_options(data, n_components, NULL);
 }
 
-PCAModel* pca_fit(Matrix *data, int n_components) {
+PCAModel* pca_fit_with_options(const Matrix *data, int n_components,
+                               const PCAOptions *options) {
+    PCAOptions opts = options ? *options : pca_default_options();
+    
     if (!data || n_components <= 0 || n_components > data->cols) {
         print_error("Invalid PCA parameters");
         return NULL;
@@ -457,97 +5514,408 @@ PCAModel* pca_fit(Matrix *data, int n_components) {
     printf("========================================\n");
     printf("Input shape: %d samples x %d features\n", data->rows, data->cols);
     printf("Target components: %d\n", n_components);
-    printf("\n");
+    printf("Solver: %s\n", pca_solver_name(opts.solver));
     
-    /* Allocate PCA model */
-    PCAModel *model = (PCAModel*)malloc(sizeof(PCAModel));
-    if (!model) {
-        print_error("Failed to allocate PCA model");
-        return NULL;
+    int use_gram = use_gram_path(data->rows, data->cols, n_components, &opts);
+    
+    if (opts.solver == PCA_SOLVER_COVARIANCE) {
+        printf("Eigen solver: %s\n", pca_eigen_solver_name(opts.eigen_solver));
+        if (opts.matrix_free) {
+            printf("Covariance: matrix-free (X^T(X v))\n");
+        } else if (use_gram) {
+            printf("Covariance: Gram matrix (X X^T, n < d)\n");
+        }
     }
+    printf("GEMM kernel: %s\n", gemm_kernel_name());
+    printf("\n");
     
-    model->n_components = n_components;
+    PCAModel *model = model_create(data->cols, n_components);
+    if (!model) return NULL;
     
-    /* Step 1: Compute mean */
-    model->mean = compute_mean(data);
-    if (!model->mean) {
-        free(model);
+    /* Steps 1-4: Statistics and the leading eigenpairs (scratch is released below) */
+    size_t mark = pca_arena_mark(opts.arena);
+    int result;
+    if (opts.solver == PCA_SOLVER_RANDOMIZED) {
+        result = fit_randomized(data, n_components, &opts, model);
+    } else if (opts.solver == PCA_SOLVER_SVD) {
+        result = fit_svd(data, n_components, &opts, model);
+    } else if (opts.matrix_free) {
+        result = fit_matrix_free(data, n_components, &opts, model);
+    } else if (use_gram) {
+        result = fit_gram(data, n_components, &opts, model);
+    } else {
+        result = fit_covariance(data, n_components, &opts, model);
+    }
+    pca_arena_release(opts.arena, mark);
+    if (result != 0) {
+        pca_free(model);
         return NULL;
     }
     
-    /* Step 2: Center data */
-    center_data(data, model->mean);
+    /* Step 5: Sort eigenvalues and eigenvectors */
+    model_finish(model);
     
-    /* Step 3: Compute covariance matrix */
-    Matrix *cov = compute_covariance(data);
-    if (!cov) {
-        free(model->mean);
-        free(model);
+    return model;
+}
+
+/* (X - mean) * V[:, :k] without progress output; only the centering block
+ * and its packing buffer are scratch */
+static Matrix* centered_projection(const Matrix *data, const double *mean,
+                                   const Matrix *eigenvectors, int k, PCAArena *arena) {
+    int d = data->cols;
+    int block_rows = (data->rows < PROJECT_BLOCK_ROWS) ? data->rows : PROJECT_BLOCK_ROWS;
+    size_t mark = pca_arena_mark(arena);
+    Matrix *projected = matrix_create(data->rows, k);
+    Matrix *block = scratch_matrix(arena, block_rows, d);
+    double *pack = (double*)scratch_alloc(arena, gemm_pack_size(block_rows, k, d, NULL) *
+                                                 sizeof(double));
+    if (!projected || !block || !pack) {
+        matrix_free(projected);
+        matrix_free(block);
+        scratch_free(arena, pack);
+        pca_arena_release(arena, mark);
         return NULL;
     }
     
-    /* Step 4: Compute eigenvalues and eigenvectors */
-    model->eigenvalues = (double*)malloc(data->cols * sizeof(double));
-    model->eigenvectors = matrix_create(data->cols, data->cols);
+    /* X_pca = (X - mean) * V[:, :k]; the GEMM reads the first k columns in place */
+    for (int r0 = 0; r0 < data->rows; r0 += block_rows) {
+        int b = (data->rows - r0 < block_rows) ? data->rows - r0 : block_rows;
+        center_rows(data, mean, r0, b, block);
+        
+        gemm_driver(b, k, d, block->values, block->stride, 0,
+                    eigenvectors->values, eigenvectors->stride,
+                    MATRIX_ROW(projected, r0), projected->stride, 0, pack);
+    }
+    
+    matrix_free(block);
+    scratch_free(arena, pack);
+    pca_arena_release(arena, mark);
     
-    if (!model->eigenvalues || !model->eigenvectors) {
-        matrix_free(cov);
-        free(model->mean);
-        if (model->eigenvalues) free(model->eigenvalues);
-        if (model->eigenvectors) matrix_free(model->eigenvectors);
-        free(model);
+    return projected;
+}
+
+/* Centered projection with progress output */
+static Matrix* project_centered(const Matrix *data, const double *mean,
+                                const Matrix *eigenvectors, int k, PCAArena *arena) {
+    print_progress("Projecting data onto principal components...");
+    
+    Matrix *projected = centered_projection(data, mean, eigenvectors, k, arena);
+    if (projected) {
+        printf("  Projected to %d dimensions\n", k);
+    }
+    
+    return projected;
+}
+
+Matrix* project_data_centered(const Matrix *data, const double *mean,
+                              const Matrix *eigenvectors, int k) {
+    if (!data || !mean || !eigenvectors || k <= 0 ||
+        k > eigenvectors->cols || data->cols != eigenvectors->rows) {
         return NULL;
     }
     
-    int result = compute_eigen(cov, model->eigenvalues, model->eigenvectors, 
-                               1000, 1e-10);
-    matrix_free(cov);
+    return project_centered(data, mean, eigenvectors, k, NULL);
+}
+
+Matrix* pca_transform(const PCAModel *model, const Matrix *data) {
+    return pca_transform_with_options(model, data, NULL);
+}
+
+Matrix* pca_transform_with_options(const PCAModel *model, const Matrix *data,
+                                   const PCAOptions *options) {
+    if (!model || !data || data->cols != model->eigenvectors->rows) return NULL;
     
-    if (result != 0) {
+    /* Center (block by block, without touching data) and project */
+    return project_centered(data, model->mean, model->eigenvectors,
+                            model->n_components, options ? options->arena : NULL);
+}
+
+Matrix* pca_fit_transform(const Matrix *data, int n_components,
+                          const PCAOptions *options, PCAModel **model_out) {
+    PCAModel *model = pca_fit_with_options(data, n_components, options);
+    if (!model) return NULL;
+    
+    Matrix *transformed = pca_transform_with_options(model, data, options);
+    
+    if (model_out && transformed) {
+        *model_out = model;
+    } else {
         pca_free(model);
-        return NULL;
     }
     
-    /* Step 5: Sort eigenvalues and eigenvectors */
-    print_progress("Sorting by eigenvalues (descending)...");
-    sort_eigen(model->eigenvalues, model->eigenvectors, data->cols);
+    return transformed;
+}
+
+/*
+ * Out-of-core fit and transform. All chunks feed one shared accumulator:
+ * a chunk is centered in place on its own mean (the reader's buffer is
+ * overwritten by the next chunk anyway), its co-moment Xc^T Xc is added
+ * to the shared upper triangle tile by tile with the tiles spread over
+ * the threads, and Chan's correction folds the chunk mean in. Resident
+ * memory is one chunk, one d x d co-moment and O(threads * d) sums,
+ * independent of the number of rows.
+ */
+
+/* Smallest co-moment tile edge worth its own GEMM call */
+#define STREAM_MIN_TILE 64
+
+/* Row range of a chunk for the column-sum and centering passes */
+typedef struct {
+    Matrix *chunk;
+    int row_start;
+    int row_end;
+    double *sums;               /* Column sums of the rows */
+    const double *mean;         /* Chunk mean to subtract */
+} ChunkCenterTask;
+
+static void chunk_sum_task(void *arg) {
+    ChunkCenterTask *t = (ChunkCenterTask*)arg;
+    int d = t->chunk->cols;
+    memset(t->sums, 0, d * sizeof(double));
+    for (int i = t->row_start; i < t->row_end; i++) {
+        const double *row = MATRIX_ROW(t->chunk, i);
+        for (int j = 0; j < d; j++) {
+            t->sums[j] += row[j];
+        }
+    }
+}
+
+static void chunk_center_task(void *arg) {
+    ChunkCenterTask *t = (ChunkCenterTask*)arg;
+    int d = t->chunk->cols;
+    for (int i = t->row_start; i < t->row_end; i++) {
+        double *row = MATRIX_ROW(t->chunk, i);
+        for (int j = 0; j < d; j++) {
+            row[j] -= t->mean[j];
+        }
+    }
+}
+
+/* Upper-triangle tiles first, first + step, ... of the shared co-moment */
+typedef struct {
+    const Matrix *centered;
+    Matrix *comoment;
+    int tile;                   /* Tile edge */
+    int tiles;                  /* Tiles per side */
+    int first;
+    int step;
+    int status;
+} ComomentTileTask;
+
+static void comoment_tile_task(void *arg) {
+    ComomentTileTask *t = (ComomentTileTask*)arg;
+    const Matrix *X = t->centered;
+    int d = X->cols;
     
-    /* Calculate explained variance */
-    double total_variance = 0.0;
-    double explained_variance = 0.0;
+    t->status = 0;
+    int index = 0;
+    for (int bi = 0; bi < t->tiles; bi++) {
+        for (int bj = bi; bj < t->tiles; bj++, index++) {
+            if (index % t->step != t->first) continue;
+            
+            int i0 = bi * t->tile;
+            int j0 = bj * t->tile;
+            int m = (d - i0 < t->tile) ? d - i0 : t->tile;
+            int n = (d - j0 < t->tile) ? d - j0 : t->tile;
+            if (gemm_driver(m, n, X->rows, X->values + i0, X->stride, 1,
+                            X->values + j0, X->stride,
+                            MATRIX_ROW(t->comoment, i0) + j0, t->comoment->stride,
+                            bi == bj, NULL) != 0) {
+                t->status = -1;
+                return;
+            }
+        }
+    }
+}
+
+/* Add one chunk to acc: center it in place, SYRK by tiles, Chan fold */
+static int stream_accumulate(CovAccumulator *acc, Matrix *chunk, int n_threads,
+                             ChunkCenterTask *center, ComomentTileTask *tiles) {
+    int d = acc->dim;
+    int row_threads = row_thread_count(n_threads, chunk->rows);
+    
+    for (int t = 0; t < row_threads; t++) {
+        center[t].chunk = chunk;
+        center[t].row_start = (int)((long long)chunk->rows * t / row_threads);
+        center[t].row_end = (int)((long long)chunk->rows * (t + 1) / row_threads);
+        center[t].mean = acc->block_mean;
+    }
+    parallel_run(row_threads, chunk_sum_task, center, sizeof(ChunkCenterTask));
+    
+    memset(acc->block_mean, 0, d * sizeof(double));
+    for (int t = 0; t < row_threads; t++) {
+        for (int j = 0; j < d; j++) {
+            acc->block_mean[j] += center[t].sums[j];
+        }
+    }
+    for (int j = 0; j < d; j++) {
+        acc->block_mean[j] /= chunk->rows;
+    }
+    parallel_run(row_threads, chunk_center_task, center, sizeof(ChunkCenterTask));
+    
+    /* Enough tiles per side to give every thread about two tiles */
+    int per_side = 1;
+    while (n_threads > 1 && per_side * (per_side + 1) / 2 < 2 * n_threads &&
+           d / (per_side + 1) >= STREAM_MIN_TILE) {
+        per_side++;
+    }
+    int tile = (d + per_side - 1) / per_side;
+    int tile_threads = per_side * (per_side + 1) / 2;
+    if (tile_threads > n_threads) tile_threads = n_threads;
     
-    for (int i = 0; i < data->cols; i++) {
-        total_variance += model->eigenvalues[i];
-        if (i < n_components) {
-            explained_variance += model->eigenvalues[i];
+    for (int t = 0; t < tile_threads; t++) {
+        tiles[t].centered = chunk;
+        tiles[t].comoment = acc->comoment;
+        tiles[t].tile = tile;
+        tiles[t].tiles = per_side;
+        tiles[t].first = t;
+        tiles[t].step = tile_threads;
+    }
+    parallel_run(tile_threads, comoment_tile_task, tiles, sizeof(ComomentTileTask));
+    for (int t = 0; t < tile_threads; t++) {
+        if (tiles[t].status != 0) {
+            print_error("Failed to allocate GEMM packing buffers");
+            return -1;
         }
     }
     
-    model->explained_variance_ratio = explained_variance / total_variance;
+    cov_accumulator_fold(acc, chunk->rows, acc->block_mean);
+    return 0;
+}
+
+PCAModel* pca_fit_stream(PCAChunkReader *reader, int n_components,
+                         const PCAOptions *options) {
+    PCAOptions opts = options ? *options : pca_default_options();
+    int d = pca_chunk_reader_cols(reader);
+    
+    if (!reader || n_components <= 0 || n_components > d) {
+        print_error("Invalid PCA parameters");
+        return NULL;
+    }
+    if (opts.arena) {
+        print_error("Streaming fit does not take scratch from an arena");
+        return NULL;
+    }
+    
+    int n_threads = resolve_thread_count(opts.n_threads);
     
     printf("\n========================================\n");
-    printf("PCA Model Training Complete\n");
+    printf("Training PCA Model (streaming)\n");
     printf("========================================\n");
-    printf("Explained variance ratio: %.4f (%.2f%%)\n", 
-           model->explained_variance_ratio, 
-           model->explained_variance_ratio * 100);
-    printf("\nTop eigenvalues:\n");
-    for (int i = 0; i < (n_components < 5 ? n_components : 5); i++) {
-        printf("  PC%d: %.6f\n", i + 1, model->eigenvalues[i]);
-    }
+    printf("Input features: %d\n", d);
+    printf("Target components: %d\n", n_components);
+    printf("Chunk: %d rows (%.2f MB), co-moment: %.2f MB\n", reader->chunk_rows,
+           (double)reader->chunk_rows * d * sizeof(double) / (1024.0 * 1024.0),
+           (double)d * d * sizeof(double) / (1024.0 * 1024.0));
+    printf("Eigen solver: %s\n", pca_eigen_solver_name(opts.eigen_solver));
     printf("\n");
     
+    PCAModel *model = model_create(d, n_components);
+    if (!model) return NULL;
+    
+    model->mean = (double*)malloc(d * sizeof(double));
+    CovAccumulator *acc = cov_accumulator_alloc(NULL, d);
+    ChunkCenterTask *center = (ChunkCenterTask*)calloc(n_threads, sizeof(ChunkCenterTask));
+    ComomentTileTask *tiles = (ComomentTileTask*)calloc(n_threads, sizeof(ComomentTileTask));
+    double *sums = (double*)malloc((size_t)n_threads * d * sizeof(double));
+    int ok = (model->mean && acc && center && tiles && sums);
+    for (int t = 0; ok && t < n_threads; t++) {
+        center[t].sums = sums + (size_t)t * d;
+    }
+    
+    /* Steps 1-2: Fold every chunk into the running statistics */
+    print_progress("Accumulating mean and covariance over chunks...");
+    Matrix *chunk = NULL;
+    int status = 0;
+    int chunks = 0;
+    while (ok && (status = pca_chunk_reader_next(reader, &chunk)) == 1) {
+        if (stream_accumulate(acc, chunk, n_threads, center, tiles) != 0) ok = 0;
+        chunks++;
+    }
+    if (status < 0) ok = 0;
+    
+    free(center);
+    free(tiles);
+    free(sums);
+    
+    Matrix *cov = NULL;
+    if (ok && acc->count < 2) {
+        print_error("Streaming fit needs at least two rows");
+        ok = 0;
+    }
+    if (ok) {
+        memcpy(model->mean, acc->mean, d * sizeof(double));
+        comoment_to_covariance(acc->comoment, acc->count);
+        cov = acc->comoment;
+        acc->comoment = NULL;
+        
+        printf("  Processed %lld rows in %d chunk%s (%d thread%s)\n",
+               acc->count, chunks, (chunks == 1) ? "" : "s",
+               n_threads, (n_threads == 1) ? "" : "s");
+    }
+    cov_accumulator_free(acc);
+    
+    /* Steps 3-4: Leading eigenpairs of the d x d covariance */
+    if (ok) {
+        model->total_variance = matrix_trace(cov);
+        if (solve_eigen(cov, n_components, &opts, model->eigenvalues,
+                        model->eigenvectors) != 0) {
+            ok = 0;
+        }
+    }
+    matrix_free(cov);
+    
+    if (!ok) {
+        print_error("Streaming fit failed");
+        pca_free(model);
+        return NULL;
+    }
+    
+    /* Step 5: Sort eigenvalues and eigenvectors */
+    model_finish(model);
+    
     return model;
 }
 
-Matrix* pca_transform(const PCAModel *model, Matrix *data) {
-    if (!model || !data) return NULL;
+int pca_transform_stream(const PCAModel *model, PCAChunkReader *reader,
+                         const char *output_file, int precision, int n_threads) {
+    if (!model || !reader || !output_file ||
+        pca_chunk_reader_cols(reader) != model->eigenvectors->rows) {
+        return -1;
+    }
+    
+    print_progress("Projecting chunks and writing results to CSV...");
     
-    /* Center data using stored mean */
-    center_data(data, model->mean);
+    off_t offset, *position;
+    int fd = csv_output_open(output_file, &offset, &position);
+    if (fd < 0) return -1;
     
-    /* Project onto principal components */
-    return project_data(data, model->eigenvectors, model->n_components);
+    /* Read, project and append one chunk at a time */
+    pca_chunk_reader_rewind(reader);
+    Matrix *chunk = NULL;
+    int status = 0;
+    int ok = 1;
+    while (ok && (status = pca_chunk_reader_next(reader, &chunk)) == 1) {
+        Matrix *projected = centered_projection(chunk, model->mean, model->eigenvectors,
+                                                model->n_components, NULL);
+        if (!projected ||
+            csv_write_rows(fd, position, projected, precision, n_threads) != 0) {
+            ok = 0;
+        }
+        matrix_free(projected);
+    }
+    if (status < 0) ok = 0;
+    
+    if (close(fd) != 0) ok = 0;
+    if (!ok) {
+        print_error("Failed to write CSV file");
+        return -1;
+    }
+    
+    printf("  Wrote %zu rows x %d columns to %s\n", pca_chunk_reader_rows(reader),
+           model->n_components, output_file);
+    
+    return 0;
 }
 
 void pca_free(PCAModel *model) {
@@ -4,12 +4,12 @@
  * This file contains declarations for the PCA algorithm implementation.
  * The algorithm follows these steps:
  *   1. Read data from CSV file
- *   2. Center the data (subtract mean)
- *   3. Compute covariance matrix
- *   4. Compute eigenvectors and eigenvalues
- *   5. Sort eigenvectors by eigenvalues (descending)
- *   6. Project data onto K principal components
- *   7. Write results to CSV file
+ *   2. Compute mean and covariance matrix in a single pass
+ *      (each block of rows is centered in scratch space)
+ *   3. Compute eigenvectors and eigenvalues
+ *   4. Sort eigenvectors by eigenvalues (descending)
+ *   5. Project data onto K principal components
+ *   6. Write results to CSV file
  * 
  * Author: PCA Lab
  * Date: October 2025
@@ -24,25 +24,144 @@
 #include <math.h>
 
 /* Configuration constants */
-#define MAX_LINE_LENGTH 4096
 #define MAX_FILENAME_LENGTH 256
+#define MATRIX_ALIGNMENT 64     /* Byte alignment of matrix buffers */
 
-/* Matrix structure */
+/* Matrix structure
+ *
+ * Elements live in a single contiguous, MATRIX_ALIGNMENT-aligned row-major
+ * buffer: element (i, j) is values[i * stride + j]. The row pointer array
+ * `data` is kept as a compatibility view so data[i][j] still works.
+ */
 typedef struct {
-    double **data;      /* 2D array of data */
+    double *values;     /* Contiguous row-major buffer */
+    double **data;      /* Row pointers into values (compatibility view) */
     int rows;          /* Number of rows (samples) */
     int cols;          /* Number of columns (features) */
+    int stride;        /* Leading dimension (doubles between row starts) */
+    int borrowed;      /* Storage owned elsewhere (arena); matrix_free ignores it */
+    void *mapping;     /* File mapping holding values (munmapped by matrix_free) */
+    size_t mapping_size; /* Length of mapping in bytes */
 } Matrix;
 
+/* Pointer to the first element of row i */
+#define MATRIX_ROW(mat, i) ((mat)->values + (size_t)(i) * (mat)->stride)
+
+/* Bump allocator for per-call scratch, released in O(1) with a mark */
+typedef struct {
+    unsigned char *base;        /* MATRIX_ALIGNMENT-aligned region */
+    size_t capacity;            /* Size of the region in bytes */
+    size_t used;                /* Bytes handed out so far */
+    size_t peak;                /* High-water mark of used */
+} PCAArena;
+
+/* Running mean and co-moment statistics, mergeable across threads/chunks */
+typedef struct {
+    int dim;                    /* Number of features */
+    long long count;            /* Rows accumulated so far */
+    double *mean;               /* Running mean of each feature */
+    Matrix *comoment;           /* Sum of centered outer products (upper triangle) */
+    double *block_mean;         /* Scratch: mean of the current block */
+    Matrix *scratch;            /* Scratch: centered copy of the current block */
+    double *pack;               /* Scratch: GEMM packing buffer of the block SYRK */
+    int block_rows;             /* Rows per block */
+} CovAccumulator;
+
+/* Eigen solver backends */
+typedef enum {
+    PCA_EIGEN_POWER = 0,        /* Power iteration with deflation (top-k) */
+    PCA_EIGEN_DENSE,            /* Householder tridiagonalization + implicit QL */
+    PCA_EIGEN_LANCZOS,          /* Thick-restart Lanczos, full reorthogonalization */
+    PCA_EIGEN_SUBSPACE          /* Block subspace iteration with Rayleigh-Ritz */
+} PCAEigenSolver;
+
+/* Fitting strategies */
+typedef enum {
+    PCA_SOLVER_COVARIANCE = 0,  /* Covariance matrix (or operator) + eigen solver */
+    PCA_SOLVER_RANDOMIZED,      /* Randomized SVD of the centered data */
+    PCA_SOLVER_SVD              /* TSQR + Jacobi SVD of the centered data */
+} PCASolver;
+
+/* Symmetric linear operator given by a matrix-vector product: y = A x */
+typedef struct {
+    int dim;                    /* A is dim x dim */
+    void (*apply)(const double *x, double *y, void *ctx);
+    void *ctx;                  /* Passed through to apply */
+    void (*destroy)(void *ctx); /* Frees ctx when owned (NULL = not owned) */
+} LinearOperator;
+
+/* Buffers of one thick-restart Lanczos run (basis x dim) */
+typedef struct {
+    int dim;                    /* Vector length the buffers fit (0 = none) */
+    int basis;                  /* Krylov basis size m */
+    Matrix *V;                  /* Krylov basis, one vector per row (m x d) */
+    Matrix *V_next;             /* Restarted basis / Ritz vectors */
+    Matrix *H;                  /* Projected matrix V^T A V (upper triangle) */
+    Matrix *H_sym;              /* Symmetrized copy of H for the dense solve */
+    Matrix *Y;                  /* Eigenvectors of H (columns) */
+    double *theta;              /* Ritz values, descending */
+    double *res;                /* Ritz residual norms */
+    double *w;                  /* Operator output / new direction */
+    double *r;                  /* Residual vector after m steps */
+    double *h;                  /* Projection coefficients */
+} LanczosWorkspace;
+
+/* Reusable eigen solver buffers, grown on first use and kept across fits */
+typedef struct {
+    int power_dim;              /* Size the power-iteration buffers fit (0 = none) */
+    Matrix *A;                  /* Deflated copy of the matrix */
+    double *v[2];               /* Ping-pong iterate buffers */
+    int block_dim;              /* Rows of the subspace block buffers (0 = none) */
+    int block;                  /* Columns of the subspace block buffers */
+    Matrix *Q;                  /* Orthonormal block (block_dim x block) */
+    Matrix *Z;                  /* A Q */
+    Matrix *T;                  /* Rotation scratch */
+    Matrix *H;                  /* Projected matrix Q^T A Q (block x block) */
+    Matrix *W;                  /* Ritz rotation */
+    double *theta;              /* Ritz values */
+    double *tau;                /* Householder scalars of the block QR */
+    double *qr_row;             /* Reflector row of the block QR */
+    int dense_dim;              /* Size the dense-solve buffers fit (0 = none) */
+    Matrix *U;                  /* Householder transform of the dense solve */
+    Matrix *U_t;                /* Its transpose, rotated by the QL sweeps */
+    double *diag;               /* Tridiagonal diagonal, then eigenvalues */
+    double *offdiag;            /* Tridiagonal subdiagonal */
+    int *order;                 /* Eigenvalue selection order */
+    LanczosWorkspace lanczos;   /* Thick-restart Lanczos buffers */
+    size_t pack_size;           /* Doubles the GEMM packing buffer holds (0 = none) */
+    double *pack;               /* GEMM packing buffer */
+    PCAArena *arena;            /* Buffer source (NULL = heap) */
+} EigenWorkspace;
+
+/* Options controlling how a PCA model is fitted */
+typedef struct {
+    int n_threads;              /* Worker threads for parallel kernels (0 = all cores) */
+    PCAEigenSolver eigen_solver; /* Eigen backend */
+    int max_iterations;         /* Iteration cap for iterative eigen solvers */
+    double tolerance;           /* Convergence tolerance for iterative eigen solvers */
+    int matrix_free;            /* Never form the covariance; apply it as X^T(X v) */
+    PCASolver solver;           /* Fitting strategy */
+    int oversample;             /* Randomized SVD: extra sketch columns beyond K */
+    int power_iterations;       /* Randomized SVD: subspace iterations */
+    EigenWorkspace *workspace;  /* Eigen solver buffers to reuse (NULL = per fit) */
+    PCAArena *arena;            /* Scratch allocator for fit/transform (NULL = heap) */
+} PCAOptions;
+
 /* PCA configuration structure */
 typedef struct {
     int n_components;           /* Number of principal components (K) */
     double *mean;              /* Mean of each feature */
-    double *eigenvalues;       /* Eigenvalues */
-    Matrix *eigenvectors;      /* Eigenvectors (components) */
+    double *eigenvalues;       /* Leading eigenvalues (n_components) */
+    Matrix *eigenvectors;      /* Leading eigenvectors (features x n_components) */
+    double total_variance;     /* Trace of the covariance matrix */
     double explained_variance_ratio;  /* Variance explained */
 } PCAModel;
 
+/* Reads a CSV file in fixed-size row chunks (opaque, see pca_chunk_reader_open) */
+typedef struct PCAChunkReader PCAChunkReader;
+
+#define PCA_STREAM_CHUNK_ROWS 65536  /* Default rows per streamed chunk */
+
 /* ============================================
  * Matrix Operations
  * ============================================ */
@@ -83,6 +202,34 @@ void matrix_print(const Matrix *mat, const char *name);
  */
 Matrix* matrix_multiply(const Matrix *A, const Matrix *B);
 
+/**
+ * Accumulate a matrix product: C += A * B
+ * Uses a packed, cache-blocked GEMM with an AVX-512, AVX2/FMA or scalar
+ * micro-kernel chosen at runtime from CPUID.
+ * @param A First matrix (m x k)
+ * @param B Second matrix (k x n)
+ * @param C Output matrix (m x n), accumulated into
+ * @return 0 on success, -1 on failure
+ */
+int matrix_gemm(const Matrix *A, const Matrix *B, Matrix *C);
+
+/**
+ * Accumulate a symmetric rank-k update: C += X^T * X
+ * Only the upper triangle is computed (reading X in place, no transpose
+ * copy); it is then mirrored into the lower triangle, so C should be
+ * symmetric on entry (e.g. zero).
+ * @param X Input matrix (n x d)
+ * @param C Output matrix (d x d), accumulated into
+ * @return 0 on success, -1 on failure
+ */
+int matrix_syrk(const Matrix *X, Matrix *C);
+
+/**
+ * Name of the GEMM micro-kernel selected for this CPU
+ * @return "avx512", "avx2" or "scalar"
+ */
+const char* gemm_kernel_name(void);
+
 /**
  * Transpose a matrix
  * @param mat Input matrix
@@ -90,27 +237,204 @@ Matrix* matrix_multiply(const Matrix *A, const Matrix *B);
  */
 Matrix* matrix_transpose(const Matrix *mat);
 
+/**
+ * Sum of the diagonal elements of a matrix
+ * @param mat Input matrix
+ * @return Trace
+ */
+double matrix_trace(const Matrix *mat);
+
+/* ============================================
+ * Memory Arena
+ * ============================================ */
+
+/**
+ * Create an arena with a fixed-size region
+ * @param capacity Region size in bytes (see pca_scratch_bytes)
+ * @return New arena, NULL on failure
+ */
+PCAArena* pca_arena_create(size_t capacity);
+
+/**
+ * Free an arena and its region
+ * @param arena Arena to free (may be NULL)
+ */
+void pca_arena_free(PCAArena *arena);
+
+/**
+ * Allocate MATRIX_ALIGNMENT-aligned bytes from the arena
+ * @param arena Arena
+ * @param bytes Number of bytes
+ * @return Pointer into the region, NULL if it is exhausted
+ */
+void* pca_arena_alloc(PCAArena *arena, size_t bytes);
+
+/**
+ * Create a zero-filled matrix whose header, row view and elements all
+ * live in the arena (matrix_free on it is a no-op)
+ * @param arena Arena
+ * @param rows Number of rows
+ * @param cols Number of columns
+ * @return Matrix, NULL if the arena is exhausted
+ */
+Matrix* pca_arena_matrix(PCAArena *arena, int rows, int cols);
+
+/**
+ * Current allocation mark, to be passed to pca_arena_release
+ * @param arena Arena (NULL returns 0)
+ * @return Mark
+ */
+size_t pca_arena_mark(const PCAArena *arena);
+
+/**
+ * Release everything allocated after a mark in O(1)
+ * @param arena Arena (NULL is a no-op)
+ * @param mark Mark from pca_arena_mark
+ */
+void pca_arena_release(PCAArena *arena, size_t mark);
+
 /* ============================================
  * File I/O Operations
  * ============================================ */
 
 /**
- * Read CSV file into matrix
+ * Read CSV file into matrix (all cores, see read_csv_parallel)
+ * The file is memory-mapped (or read whole when it cannot be mapped) and
+ * parsed in a single pass; blank lines are skipped and every row must
+ * have as many fields as the first. A field that is not a number, or a
+ * row with a different field count, fails the read with its row, column
+ * and byte offset.
  * @param filename Path to CSV file
  * @return Matrix containing the data, NULL on failure
  */
 Matrix* read_csv(const char *filename);
 
+/**
+ * Read CSV file into matrix using several threads
+ * The mapped file is cut into byte ranges aligned to line starts; threads
+ * count the rows of each range, a prefix sum gives every range its first
+ * row, and the ranges are then parsed concurrently into their rows.
+ * @param filename Path to CSV file
+ * @param n_threads Number of threads (0 = all cores)
+ * @return Matrix containing the data, NULL on failure
+ */
+Matrix* read_csv_parallel(const char *filename, int n_threads);
+
 /**
  * Write matrix to CSV file
+ * Values are written in a short form that reads back to the same double
+ * (see pca_format_double).
  * @param mat Matrix to write
  * @param filename Output filename
  * @return 0 on success, -1 on failure
  */
 int write_csv(const Matrix *mat, const char *filename);
 
+/**
+ * Write matrix to CSV file with a chosen number format (all cores, see
+ * write_csv_parallel)
+ * @param mat Matrix to write
+ * @param filename Output filename
+ * @param precision Digits after the decimal point (as "%.Nf", capped at
+ *                  PCA_FORMAT_MAX_PRECISION), or negative for the shortest
+ *                  round-trip form
+ * @return 0 on success, -1 on failure
+ */
+int write_csv_precision(const Matrix *mat, const char *filename, int precision);
+
+/**
+ * Write matrix to CSV file using several threads
+ * Each round, every thread formats a block of rows into its own buffer
+ * and the blocks are written in row order by one pwritev at the running
+ * file offset (writev if the output is not seekable).
+ * @param mat Matrix to write
+ * @param filename Output filename
+ * @param precision Digits after the decimal point, or negative for the
+ *                  shortest round-trip form (see pca_format_double)
+ * @param n_threads Number of threads (0 = all cores)
+ * @return 0 on success, -1 on failure
+ */
+int write_csv_parallel(const Matrix *mat, const char *filename, int precision, int n_threads);
+
+/* Element types and layouts of the binary matrix format */
+#define PCA_DTYPE_FLOAT64 1
+#define PCA_DTYPE_FLOAT32 2
+#define PCA_LAYOUT_ROW_MAJOR 0
+#define PCA_LAYOUT_COL_MAJOR 1
+
+/**
+ * Read a binary matrix file
+ * The file is a 64-byte header (magic "PCAMATRX", version 1, byte-order
+ * tag 0x01020304, dtype, layout, rows, cols and payload offset, all in
+ * native byte order) followed by the elements. A float64 row-major
+ * payload at an offset that is a multiple of MATRIX_ALIGNMENT is mapped
+ * and used as the matrix buffer without copying; float32 or
+ * column-major payloads are converted.
+ * @param filename Path to binary matrix file
+ * @return Matrix containing the data, NULL on failure
+ */
+Matrix* read_matrix_binary(const char *filename);
+
+/**
+ * Write matrix to a binary matrix file (float64, row-major, payload at
+ * byte 64), readable back with read_matrix_binary without copying
+ * @param mat Matrix to write
+ * @param filename Output filename
+ * @return 0 on success, -1 on failure
+ */
+int write_matrix_binary(const Matrix *mat, const char *filename);
+
+/**
+ * Read a NumPy .npy file (format versions 1-3)
+ * Accepts native-endian float64 or float32 arrays of shape (n, d), or
+ * (n,) read as a single column, in C or Fortran order. C-order float64
+ * payloads (64-byte aligned, as NumPy writes them) are mapped and used
+ * without copying; anything else is converted.
+ * @param filename Path to .npy file
+ * @return Matrix containing the data, NULL on failure
+ */
+Matrix* read_npy(const char *filename);
+
+/**
+ * Write matrix to a NumPy .npy file (version 1.0, float64, C order)
+ * @param mat Matrix to write
+ * @param filename Output filename
+ * @return 0 on success, -1 on failure
+ */
+int write_npy(const Matrix *mat, const char *filename);
+
+/**
+ * Parse a decimal floating-point number, independent of the C locale
+ * Accepts an optional sign, digits with an optional '.', an optional
+ * exponent, and inf/infinity/nan. The result is correctly rounded.
+ * @param begin First character of the number
+ * @param end End of the input (the text need not be NUL-terminated)
+ * @param value Pointer to store the parsed value
+ * @return Pointer just past the number, NULL if no number starts at begin
+ */
+const char* pca_parse_double(const char *begin, const char *end, double *value);
+
+/* Limits of pca_format_double */
+#define PCA_FORMAT_MAX_PRECISION 20
+#define PCA_FORMAT_MAX_CHARS 336    /* Longest output: "-" + 309 digits + "." + 20 */
+
+/**
+ * Format a double as text, independent of the C locale (no NUL added)
+ * @param value Value to format
+ * @param precision Digits after the decimal point (as "%.Nf", capped at
+ *                  PCA_FORMAT_MAX_PRECISION), or negative for a string
+ *                  that parses back to the same double: never longer than
+ *                  "%.17g" and the shortest such string in all but rare
+ *                  cases (Grisu2 may add a digit)
+ * @param out Output buffer of at least PCA_FORMAT_MAX_CHARS bytes
+ * @return Number of characters written
+ */
+int pca_format_double(double value, int precision, char *out);
+
 /**
  * Count rows and columns in CSV file
+ * Uses the same line scanner as read_csv: lines of any length, blank lines
+ * not counted, columns taken from the first data row.
  * @param filename Path to CSV file
  * @param rows Pointer to store row count
  * @param cols Pointer to store column count
@@ -118,6 +442,54 @@ int write_csv(const Matrix *mat, const char *filename);
  */
 int get_csv_dimensions(const char *filename, int *rows, int *cols);
 
+/**
+ * Open a CSV file for reading in chunks of rows
+ * The file is memory-mapped (it must be a regular file) and the pages
+ * behind consumed chunks are released, so only one parsed chunk is
+ * resident at a time.
+ * @param filename Path to CSV file
+ * @param chunk_rows Rows per chunk (the last chunk may be shorter)
+ * @param n_threads Threads for parsing each chunk (0 = all cores)
+ * @return Reader, NULL on failure
+ */
+PCAChunkReader* pca_chunk_reader_open(const char *filename, int chunk_rows, int n_threads);
+
+/**
+ * Number of columns, taken from the first data row
+ * @param reader Chunk reader
+ * @return Column count
+ */
+int pca_chunk_reader_cols(const PCAChunkReader *reader);
+
+/**
+ * Read the next chunk of rows
+ * The chunk is owned by the reader; its buffer is reused, so the rows
+ * are overwritten by the next call.
+ * @param reader Chunk reader
+ * @param chunk Output for the chunk (rows x cols)
+ * @return 1 if a chunk was read, 0 at end of file, -1 on failure
+ */
+int pca_chunk_reader_next(PCAChunkReader *reader, Matrix **chunk);
+
+/**
+ * Start again from the first data row
+ * @param reader Chunk reader
+ */
+void pca_chunk_reader_rewind(PCAChunkReader *reader);
+
+/**
+ * Rows read since opening or the last rewind
+ * @param reader Chunk reader
+ * @return Row count
+ */
+size_t pca_chunk_reader_rows(const PCAChunkReader *reader);
+
+/**
+ * Close a chunk reader and unmap its file
+ * @param reader Chunk reader
+ */
+void pca_chunk_reader_close(PCAChunkReader *reader);
+
 /* ============================================
  * Statistical Operations
  * ============================================ */
@@ -143,10 +515,99 @@ void center_data(Matrix *mat, const double *mean);
  */
 Matrix* compute_covariance(const Matrix *mat);
 
+/**
+ * Compute covariance matrix using several threads
+ * Rows are split into one block per thread; each thread accumulates a
+ * private partial X^T X and the partials are summed at the end.
+ * @param mat Input matrix (should be centered)
+ * @param n_threads Number of threads (0 = all cores)
+ * @return Covariance matrix (cols x cols)
+ */
+Matrix* compute_covariance_parallel(const Matrix *mat, int n_threads);
+
+/**
+ * Create an empty mean/covariance accumulator
+ * @param dim Number of features
+ * @return New accumulator, NULL on failure
+ */
+CovAccumulator* cov_accumulator_create(int dim);
+
+/**
+ * Free an accumulator
+ * @param acc Accumulator to free
+ */
+void cov_accumulator_free(CovAccumulator *acc);
+
+/**
+ * Add rows [row_start, row_end) of a matrix to the running statistics
+ * Each block of rows is centered on its own mean in scratch space and
+ * folded in with Chan's pairwise formula; the input is not modified.
+ * @param acc Accumulator
+ * @param data Input matrix (cols must equal acc->dim)
+ * @param row_start First row to add
+ * @param row_end One past the last row to add
+ * @return 0 on success, -1 on failure
+ */
+int cov_accumulator_update(CovAccumulator *acc, const Matrix *data,
+                           int row_start, int row_end);
+
+/**
+ * Merge the statistics of src into dst (Chan's pairwise formula)
+ * @param dst Accumulator to merge into
+ * @param src Accumulator to merge from (unchanged)
+ * @return 0 on success, -1 on failure
+ */
+int cov_accumulator_merge(CovAccumulator *dst, const CovAccumulator *src);
+
+/**
+ * Build the sample covariance matrix from accumulated statistics
+ * @param acc Accumulator
+ * @return Covariance matrix (dim x dim), NULL on failure
+ */
+Matrix* cov_accumulator_covariance(const CovAccumulator *acc);
+
+/**
+ * Compute mean and covariance in a single pass over the data
+ * Rows are split across threads, each with its own accumulator, and the
+ * accumulators are merged at the end. The input is not modified.
+ * @param data Input matrix (not centered)
+ * @param n_threads Number of threads (0 = all cores)
+ * @param mean Output: newly allocated mean array (size = data->cols)
+ * @param cov Output: newly allocated covariance matrix (cols x cols)
+ * @return 0 on success, -1 on failure
+ */
+int compute_mean_covariance(const Matrix *data, int n_threads,
+                            double **mean, Matrix **cov);
+
+/**
+ * Compute the sample Gram matrix Xc Xc^T / (n - 1) of the centered data
+ * Used instead of the covariance when there are fewer samples than
+ * features; it shares the covariance's nonzero eigenvalues. Features are
+ * centered in slabs, so the input is not modified.
+ * @param data Input matrix (n x d, not centered)
+ * @param mean Feature means (size = data->cols)
+ * @return Gram matrix (n x n), NULL on failure
+ */
+Matrix* compute_gram_matrix(const Matrix *data, const double *mean);
+
 /* ============================================
  * PCA Core Algorithm
  * ============================================ */
 
+/**
+ * Create an empty eigen solver workspace
+ * Buffers are allocated on first use and reused by later solves of the
+ * same shape; pass it through PCAOptions.workspace to reuse it across fits.
+ * @return New workspace, NULL on failure
+ */
+EigenWorkspace* eigen_workspace_create(void);
+
+/**
+ * Free an eigen solver workspace and all its buffers
+ * @param ws Workspace to free (may be NULL)
+ */
+void eigen_workspace_free(EigenWorkspace *ws);
+
 /**
  * Compute eigenvalues and eigenvectors using Power Iteration method
  * @param cov_matrix Covariance matrix
@@ -159,6 +620,138 @@ Matrix* compute_covariance(const Matrix *mat);
 int compute_eigen(const Matrix *cov_matrix, double *eigenvalues, 
                  Matrix *eigenvectors, int max_iterations, double tolerance);
 
+/**
+ * Compute only the leading eigenpairs using Power Iteration with deflation
+ * Stops after n_eigen pairs; total variance can be taken from the trace.
+ * @param cov_matrix Covariance matrix (d x d)
+ * @param n_eigen Number of eigenpairs to compute
+ * @param eigenvalues Output array for eigenvalues (size >= n_eigen)
+ * @param eigenvectors Output matrix for eigenvectors (d x >= n_eigen)
+ * @param max_iterations Maximum iterations for convergence
+ * @param tolerance Convergence tolerance
+ * @param workspace Reusable buffers (NULL = allocate for this call)
+ * @return 0 on success, -1 on failure
+ */
+int compute_eigen_topk(const Matrix *cov_matrix, int n_eigen, double *eigenvalues,
+                       Matrix *eigenvectors, int max_iterations, double tolerance,
+                       EigenWorkspace *workspace);
+
+/**
+ * Compute the leading eigenpairs with a dense symmetric solver
+ * Householder reduction to tridiagonal form followed by implicit-shift
+ * QL: deterministic O(d^3) cost and orthogonal eigenvectors.
+ * @param cov_matrix Symmetric matrix (d x d)
+ * @param n_eigen Number of eigenpairs to return (largest first)
+ * @param eigenvalues Output array for eigenvalues (size >= n_eigen)
+ * @param eigenvectors Output matrix for eigenvectors (d x >= n_eigen)
+ * @param workspace Reusable buffers (NULL = allocate for this call)
+ * @return 0 on success, -1 on failure
+ */
+int compute_eigen_dense(const Matrix *cov_matrix, int n_eigen, double *eigenvalues,
+                        Matrix *eigenvectors, EigenWorkspace *workspace);
+
+/**
+ * Compute the leading eigenpairs with block subspace iteration
+ * A d x (k + guard) block is multiplied with GEMM, re-orthonormalized
+ * with Householder QR and rotated by Rayleigh-Ritz each iteration, so
+ * all k pairs converge together without deflation.
+ * @param cov_matrix Symmetric matrix (d x d)
+ * @param n_eigen Number of eigenpairs to compute (largest first)
+ * @param eigenvalues Output array for eigenvalues (size >= n_eigen)
+ * @param eigenvectors Output matrix for eigenvectors (d x >= n_eigen)
+ * @param max_iterations Maximum number of block iterations
+ * @param tolerance Residual tolerance relative to the largest eigenvalue
+ * @param workspace Reusable buffers (NULL = allocate for this call)
+ * @return 0 on success, -1 on failure
+ */
+int compute_eigen_subspace(const Matrix *cov_matrix, int n_eigen, double *eigenvalues,
+                           Matrix *eigenvectors, int max_iterations, double tolerance,
+                           EigenWorkspace *workspace);
+
+/**
+ * Wrap a dense symmetric matrix as a linear operator
+ * @param op Output operator (keeps a pointer to A)
+ * @param A Symmetric matrix
+ */
+void linear_operator_from_matrix(LinearOperator *op, const Matrix *A);
+
+/**
+ * Create a matrix-free covariance operator
+ * Applies y = (X - 1 m^T)^T (X - 1 m^T) v / (n - 1) with one streaming
+ * pass over X per product and O(d) memory per thread; the d x d
+ * covariance is never formed.
+ * @param op Output operator (release with linear_operator_release)
+ * @param data Input data (n x d, not centered, must outlive op)
+ * @param mean Mean of each feature (must outlive op)
+ * @param n_threads Number of threads (0 = all cores)
+ * @return 0 on success, -1 on failure
+ */
+int linear_operator_covariance(LinearOperator *op, const Matrix *data,
+                               const double *mean, int n_threads);
+
+/**
+ * Release resources owned by a linear operator
+ * @param op Operator
+ */
+void linear_operator_release(LinearOperator *op);
+
+/**
+ * Compute the leading eigenpairs of a symmetric operator with
+ * thick-restart Lanczos (symmetric Krylov-Schur) and full
+ * reorthogonalization. Only matrix-vector products are needed.
+ * @param op Symmetric linear operator
+ * @param n_eigen Number of eigenpairs to compute (largest first)
+ * @param eigenvalues Output array for eigenvalues (size >= n_eigen)
+ * @param eigenvectors Output matrix for eigenvectors (dim x >= n_eigen)
+ * @param residuals Optional output of residual norms ||A x - lambda x|| (NULL = skip)
+ * @param max_restarts Maximum number of restart cycles
+ * @param tolerance Residual tolerance relative to the largest eigenvalue
+ * @param workspace Reusable buffers (NULL = allocate for this call)
+ * @return 0 on success, -1 on failure
+ */
+int compute_eigen_lanczos(const LinearOperator *op, int n_eigen, double *eigenvalues,
+                          Matrix *eigenvectors, double *residuals,
+                          int max_restarts, double tolerance,
+                          EigenWorkspace *workspace);
+
+/**
+ * Compute principal components with a randomized SVD (Halko, Martinsson
+ * & Tropp) of the implicitly centered data: Gaussian sketch, subspace
+ * iterations re-orthonormalized by Householder QR, and a one-sided
+ * Jacobi SVD of the small projected matrix.
+ * @param data Input data (n x d, not centered, not modified)
+ * @param mean Mean of each feature
+ * @param n_components Number of components (K)
+ * @param oversample Extra sketch columns beyond K
+ * @param power_iterations Number of subspace iterations
+ * @param n_threads Number of threads (0 = all cores)
+ * @param eigenvalues Output: covariance eigenvalues (size >= K)
+ * @param eigenvectors Output: principal axes (d x >= K)
+ * @param arena Scratch allocator (NULL = heap)
+ * @return 0 on success, -1 on failure
+ */
+int randomized_pca(const Matrix *data, const double *mean, int n_components,
+                   int oversample, int power_iterations, int n_threads,
+                   double *eigenvalues, Matrix *eigenvectors, PCAArena *arena);
+
+/**
+ * Compute principal components from an exact SVD of the centered data
+ * A tall-skinny QR (TSQR) streams row blocks per thread into d x d R
+ * factors and reduces them; the right singular vectors of R (one-sided
+ * Jacobi) are the principal axes. The covariance is never formed, so
+ * small components keep their accuracy.
+ * @param data Input data (n x d, not centered, not modified)
+ * @param mean Mean of each feature
+ * @param n_components Number of components (K)
+ * @param n_threads Number of threads (0 = all cores)
+ * @param eigenvalues Output: covariance eigenvalues (size >= K)
+ * @param eigenvectors Output: principal axes (d x >= K)
+ * @param arena Scratch allocator (NULL = heap)
+ * @return 0 on success, -1 on failure
+ */
+int tsqr_pca(const Matrix *data, const double *mean, int n_components, int n_threads,
+             double *eigenvalues, Matrix *eigenvectors, PCAArena *arena);
+
 /**
  * Sort eigenvalues and eigenvectors in descending order
  * @param eigenvalues Array of eigenvalues
@@ -176,21 +769,144 @@ void sort_eigen(double *eigenvalues, Matrix *eigenvectors, int n);
  */
 Matrix* project_data(const Matrix *data, const Matrix *eigenvectors, int k);
 
+/**
+ * Get the default fitting options
+ * @return Options with every field set to its default
+ */
+PCAOptions pca_default_options(void);
+
+/**
+ * Center data on a given mean and project it onto principal components
+ * Centering happens block by block in scratch space; data is not modified.
+ * @param data Input data (not centered)
+ * @param mean Mean of each feature
+ * @param eigenvectors Principal components
+ * @param k Number of components to use
+ * @return Projected data (rows x k)
+ */
+Matrix* project_data_centered(const Matrix *data, const double *mean,
+                              const Matrix *eigenvectors, int k);
+
+/**
+ * Name of an eigen solver backend (as accepted on the command line)
+ * @param solver Eigen solver
+ * @return Static name string
+ */
+const char* pca_eigen_solver_name(PCAEigenSolver solver);
+
+/**
+ * Parse an eigen solver name
+ * @param name Solver name (e.g. "power", "dense")
+ * @param solver Output solver
+ * @return 0 on success, -1 if the name is unknown
+ */
+int pca_eigen_solver_parse(const char *name, PCAEigenSolver *solver);
+
+/**
+ * Name of a fitting strategy (as accepted on the command line)
+ * @param solver Solver
+ * @return Static name string
+ */
+const char* pca_solver_name(PCASolver solver);
+
+/**
+ * Parse a fitting strategy name
+ * @param name Solver name (e.g. "covariance", "randomized", "svd")
+ * @param solver Output solver
+ * @return 0 on success, -1 if the name is unknown
+ */
+int pca_solver_parse(const char *name, PCASolver *solver);
+
+/**
+ * Upper bound on the arena bytes one fit + transform needs
+ * Mirrors the scratch allocations of the selected path, including the
+ * GEMM packing, QR and eigen solver buffers, so an arena of this size
+ * never runs out and its peak is the true scratch footprint. Eigen
+ * buffers are left out when options->workspace supplies them; the
+ * per-thread vectors of the matrix-free operator stay on the heap.
+ * @param n_samples Number of rows (n)
+ * @param n_features Number of columns (d)
+ * @param n_components Number of principal components
+ * @param options Fitting options (NULL = defaults)
+ * @return Bytes, 0 for invalid dimensions
+ */
+size_t pca_scratch_bytes(int n_samples, int n_features, int n_components,
+                         const PCAOptions *options);
+
+/**
+ * Create and train PCA model with default options
+ * @param data Input data matrix (not modified)
+ * @param n_components Number of principal components
+ * @return Trained PCA model
+ */
+PCAModel* pca_fit(const Matrix *data, int n_components);
+
 /**
  * Create and train PCA model
- * @param data Input data matrix
+ * @param data Input data matrix (not modified)
  * @param n_components Number of principal components
+ * @param options Fitting options (NULL = defaults)
  * @return Trained PCA model
  */
-PCAModel* pca_fit(Matrix *data, int n_components);
+PCAModel* pca_fit_with_options(const Matrix *data, int n_components,
+                               const PCAOptions *options);
 
 /**
  * Transform data using fitted PCA model
  * @param model Fitted PCA model
- * @param data Input data
+ * @param data Input data (not modified)
  * @return Transformed data
  */
-Matrix* pca_transform(const PCAModel *model, Matrix *data);
+Matrix* pca_transform(const PCAModel *model, const Matrix *data);
+
+/**
+ * Transform data using fitted PCA model, taking scratch from options->arena
+ * @param model Fitted PCA model
+ * @param data Input data (not modified)
+ * @param options Options (only arena is used; NULL = heap)
+ * @return Transformed data
+ */
+Matrix* pca_transform_with_options(const PCAModel *model, const Matrix *data,
+                                   const PCAOptions *options);
+
+/**
+ * Fit a PCA model and transform the same, already-loaded data
+ * @param data Input data matrix (not modified)
+ * @param n_components Number of principal components
+ * @param options Fitting options (NULL = defaults)
+ * @param model_out Optional output for the fitted model (NULL = discard)
+ * @return Transformed data (rows x n_components), NULL on failure
+ */
+Matrix* pca_fit_transform(const Matrix *data, int n_components,
+                          const PCAOptions *options, PCAModel **model_out);
+
+/**
+ * Train a PCA model out of core, one chunk of rows at a time
+ * Each chunk is centered in place, its co-moment is added to a single
+ * shared d x d matrix (upper-triangle tiles split across threads) and
+ * the chunk mean is folded in with Chan's formula. Memory is bounded by
+ * one chunk plus one d x d matrix whatever the number of rows. Always
+ * uses the covariance path (options->solver and matrix_free are
+ * ignored); an options->arena is rejected.
+ * @param reader Chunk reader positioned at the start of the data
+ * @param n_components Number of principal components
+ * @param options Fitting options (NULL = defaults)
+ * @return Trained PCA model, NULL on failure
+ */
+PCAModel* pca_fit_stream(PCAChunkReader *reader, int n_components,
+                         const PCAOptions *options);
+
+/**
+ * Project every chunk of a reader and write the results to a CSV file
+ * @param model Fitted PCA model
+ * @param reader Chunk reader (rewound before reading)
+ * @param output_file Output CSV path
+ * @param precision Decimals per value, or -1 for shortest round-trip
+ * @param n_threads Threads for formatting (0 = all cores)
+ * @return 0 on success, -1 on failure
+ */
+int pca_transform_stream(const PCAModel *model, PCAChunkReader *reader,
+                         const char *output_file, int precision, int n_threads);
 
 /**
  * Free PCA model memory
@@ -226,6 +942,13 @@ void vector_normalize(double *vec, int size);
  */
 double vector_dot(const double *vec1, const double *vec2, int size);
 
+/**
+ * Resolve a requested thread count
+ * @param requested Requested threads (0 or negative = all online cores)
+ * @return Number of threads to use (at least 1)
+ */
+int resolve_thread_count(int requested);
+
 /**
  * Print progress information
  * @param message Progress message
@@ -0,0 +1,381 @@
+/*
+ * Tests for the PCA library: number parsing against strtod, number
+ * formatting against printf plus round-trip, and every eigen backend and
+ * fitting strategy against the dense solver (heap, arena and reused
+ * workspace). Build and run with `make test`.
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../src/pca.h"
+
+static int failures = 0;
+static int checks = 0;
+
+#define CHECK(cond, ...) do {                                   \
+    checks++;                                                   \
+    if (!(cond)) {                                              \
+        if (failures++ < 20) {                                  \
+            fprintf(stderr, "  FAIL %s:%d: ", __FILE__, __LINE__); \
+            fprintf(stderr, __VA_ARGS__);                       \
+            fprintf(stderr, "\n");                              \
+        }                                                       \
+    }                                                           \
+} while (0)
+
+/* xorshift64: reproducible inputs without touching rand() */
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double rng_gaussian(void) {
+    double u1 = ((rng_next() >> 11) + 0.5) / 9007199254740992.0;
+    double u2 = ((rng_next() >> 11) + 0.5) / 9007199254740992.0;
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+/* Random finite double over the whole exponent range */
+static double rng_double(void) {
+    for (;;) {
+        uint64_t bits = rng_next();
+        double v;
+        memcpy(&v, &bits, sizeof(v));
+        if (isfinite(v)) return v;
+    }
+}
+
+static int same_bits(double a, double b) {
+    return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+/* The fits print progress; keep it out of the test report */
+static int saved_stdout = -1;
+
+static void silence_stdout(void) {
+    fflush(stdout);
+    saved_stdout = dup(STDOUT_FILENO);
+    int null_fd = open("/dev/null", O_WRONLY);
+    if (null_fd >= 0) {
+        dup2(null_fd, STDOUT_FILENO);
+        close(null_fd);
+    }
+}
+
+static void restore_stdout(void) {
+    fflush(stdout);
+    if (saved_stdout >= 0) {
+        dup2(saved_stdout, STDOUT_FILENO);
+        close(saved_stdout);
+        saved_stdout = -1;
+    }
+}
+
+/* ============================================
+ * Number parsing
+ * ============================================ */
+
+/* pca_parse_double must consume the whole text and match strtod bit for bit */
+static void check_parse(const char *text) {
+    double value = 0.0;
+    const char *end = pca_parse_double(text, text + strlen(text), &value);
+    double expected = strtod(text, NULL);
+    CHECK(end && *end == '\0', "parse stopped early on \"%s\"", text);
+    CHECK(same_bits(value, expected) || (isnan(value) && isnan(expected)),
+          "parse \"%s\" = %.17g, strtod = %.17g", text, value, expected);
+}
+
+static void test_parse(void) {
+    static const char *cases[] = {
+        "0", "-0", "1", "-1", "0.1", "1e23", "8.98846567431158e307",
+        "1.7976931348623157e308", "1.7976931348623158e308", "1.8e308",
+        "2.2250738585072011e-308", "2.2250738585072014e-308",
+        "4.9406564584124654e-324", "2.4703282292062328e-324",
+        "2.4703282292062327e-324", "1e-400", "1e400", "123456789012345678901234567890",
+        "9007199254740993", "9007199254740992.5", "0.30000000000000004",
+        "1.00000000000000011102230246251565404236316680908203125",
+        "1.00000000000000011102230246251565404236316680908203124",
+        "1.00000000000000011102230246251565404236316680908203126",
+        "7.2057594037927933e16", "1e-5", "00000.000001e6", ".5", "5.", "+3.25",
+        "1E+10", "inf", "-infinity", "nan",
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        check_parse(cases[i]);
+    }
+
+    char text[128];
+    for (int i = 0; i < 200000; i++) {
+        switch (i % 4) {
+            case 0:
+                snprintf(text, sizeof(text), "%.17g", rng_double());
+                break;
+            case 1:
+                snprintf(text, sizeof(text), "%.*e", (int)(rng_next() % 17), rng_double());
+                break;
+            case 2:
+                snprintf(text, sizeof(text), "%.6f", rng_gaussian() * 1000.0);
+                break;
+            default: {
+                /* Long mantissas and extreme exponents, including halfway digits */
+                int len = 1 + (int)(rng_next() % 30);
+                int k = 0;
+                if (rng_next() % 2) text[k++] = '-';
+                for (int j = 0; j < len; j++) {
+                    text[k++] = (char)('0' + rng_next() % 10);
+                    if (j == 0 && rng_next() % 2) text[k++] = '.';
+                }
+                snprintf(text + k, sizeof(text) - k, "e%d", (int)(rng_next() % 700) - 360);
+                break;
+            }
+        }
+        check_parse(text);
+    }
+
+    double value;
+    const char *bad = "1.2.3";
+    const char *end = pca_parse_double(bad, bad + strlen(bad), &value);
+    CHECK(end && *end == '.', "parse of \"1.2.3\" should stop at the second '.'");
+    const char *word = "x1";
+    CHECK(pca_parse_double(word, word + 2, &value) == NULL, "parse of \"x1\" should fail");
+}
+
+/* ============================================
+ * Number formatting
+ * ============================================ */
+
+/* Significant digits of a decimal string (sign, point and exponent dropped) */
+static int significant_digits(const char *text) {
+    char digits[PCA_FORMAT_MAX_CHARS + 1];
+    int n = 0;
+    for (const char *p = text; *p && *p != 'e' && *p != 'E'; p++) {
+        if (*p >= '0' && *p <= '9') digits[n++] = *p;
+    }
+    int first = 0;
+    while (first < n && digits[first] == '0') first++;
+    while (n > first && digits[n - 1] == '0') n--;
+    return n - first;
+}
+
+/* Fewest significant digits that read back to value */
+static int shortest_digits(double value) {
+    char text[64];
+    for (int p = 1; p <= 17; p++) {
+        snprintf(text, sizeof(text), "%.*e", p - 1, value);
+        if (same_bits(strtod(text, NULL), value)) return significant_digits(text);
+    }
+    return 17;
+}
+
+/* Shortest outputs longer than needed (Grisu2 misses a few) */
+static int format_not_shortest = 0;
+
+static void check_format(double value) {
+    char out[PCA_FORMAT_MAX_CHARS + 1];
+    char expected[PCA_FORMAT_MAX_CHARS + 1];
+
+    /* Shortest: reads back exactly and never needs more digits than %.17g */
+    out[pca_format_double(value, -1, out)] = '\0';
+    snprintf(expected, sizeof(expected), "%.17g", value);
+    CHECK(same_bits(strtod(out, NULL), value), "shortest \"%s\" does not read back to %s",
+          out, expected);
+    CHECK(significant_digits(out) <= significant_digits(expected),
+          "shortest \"%s\" is longer than %%.17g \"%s\"", out, expected);
+    if (value != 0.0 && significant_digits(out) > shortest_digits(value)) {
+        format_not_shortest++;
+    }
+
+    /* Fixed: identical to printf */
+    int precision = (int)(rng_next() % (PCA_FORMAT_MAX_PRECISION + 1));
+    out[pca_format_double(value, precision, out)] = '\0';
+    snprintf(expected, sizeof(expected), "%.*f", precision, value);
+    CHECK(strcmp(out, expected) == 0, "fixed %d of %.17g: \"%s\", printf \"%s\"",
+          precision, value, out, expected);
+}
+
+static void test_format(void) {
+    static const double cases[] = {
+        0.0, -0.0, 1.0, -1.0, 0.1, 0.5, 1e23, 5e-324, 2.2250738585072014e-308,
+        1.7976931348623157e308, 9007199254740993.0, 123456.789, 1e-7, 1e21, 0.3,
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        check_format(cases[i]);
+    }
+    int count = 100000;
+    for (int i = 0; i < count; i++) {
+        check_format((i % 2) ? rng_double() : rng_gaussian() * pow(10.0, (int)(rng_next() % 12) - 4));
+    }
+    CHECK(format_not_shortest * 1000 < count, "%d of %d shortest outputs had extra digits",
+          format_not_shortest, count);
+}
+
+/* ============================================
+ * Cross-solver comparison
+ * ============================================ */
+
+/* Offset low-rank data with a geometric spectrum plus a little noise, so
+ * the leading eigenvalues are well separated */
+static Matrix* make_data(int n, int d, int rank, double noise) {
+    Matrix *X = matrix_create(n, d);
+    Matrix *W = matrix_create(rank, d);
+    for (int r = 0; r < rank; r++) {
+        for (int j = 0; j < d; j++) {
+            MATRIX_ROW(W, r)[j] = rng_gaussian();
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        double *row = MATRIX_ROW(X, i);
+        for (int j = 0; j < d; j++) {
+            row[j] = 100.0 + j + noise * rng_gaussian();
+        }
+        for (int r = 0; r < rank; r++) {
+            double g = rng_gaussian() * 10.0 / (1 << r);
+            for (int j = 0; j < d; j++) {
+                row[j] += g * MATRIX_ROW(W, r)[j];
+            }
+        }
+    }
+    matrix_free(W);
+    return X;
+}
+
+typedef struct {
+    const char *name;
+    PCAEigenSolver eigen_solver;
+    PCASolver solver;
+    int matrix_free;
+    double tolerance;           /* Allowed eigenvalue / eigenvector error */
+} SolverCase;
+
+/* Eigenvalues relative to the largest, eigenvectors up to sign */
+static void compare_models(const PCAModel *ref, const PCAModel *model, double tolerance,
+                           const char *label) {
+    int k = ref->n_components;
+    int d = ref->eigenvectors->rows;
+    double scale = fabs(ref->eigenvalues[0]) > 0.0 ? fabs(ref->eigenvalues[0]) : 1.0;
+
+    for (int c = 0; c < k; c++) {
+        double err = fabs(model->eigenvalues[c] - ref->eigenvalues[c]) / scale;
+        CHECK(err <= tolerance, "%s: eigenvalue %d is %.12g, dense %.12g", label, c,
+              model->eigenvalues[c], ref->eigenvalues[c]);
+
+        double dot = 0.0;
+        for (int j = 0; j < d; j++) {
+            dot += MATRIX_ROW(ref->eigenvectors, j)[c] * MATRIX_ROW(model->eigenvectors, j)[c];
+        }
+        CHECK(1.0 - fabs(dot) <= tolerance, "%s: eigenvector %d has |cos| %.12f to dense",
+              label, c, fabs(dot));
+    }
+}
+
+static void test_solvers(void) {
+    static const SolverCase cases[] = {
+        { "subspace",    PCA_EIGEN_SUBSPACE, PCA_SOLVER_COVARIANCE, 0, 1e-8 },
+        { "power",       PCA_EIGEN_POWER,    PCA_SOLVER_COVARIANCE, 0, 1e-5 },
+        { "dense",       PCA_EIGEN_DENSE,    PCA_SOLVER_COVARIANCE, 0, 1e-10 },
+        { "lanczos",     PCA_EIGEN_LANCZOS,  PCA_SOLVER_COVARIANCE, 0, 1e-8 },
+        { "matrix-free", PCA_EIGEN_LANCZOS,  PCA_SOLVER_COVARIANCE, 1, 1e-8 },
+        { "randomized",  PCA_EIGEN_SUBSPACE, PCA_SOLVER_RANDOMIZED, 0, 1e-8 },
+        { "svd",         PCA_EIGEN_SUBSPACE, PCA_SOLVER_SVD,        0, 1e-8 },
+    };
+    /* Tall (covariance path), wide (Gram path) and rank-deficient inputs */
+    static const int shapes[][4] = {
+        { 300, 20, 8, 5 },      /* n, d, rank, k */
+        { 30, 100, 8, 3 },
+        { 3, 40, 3, 2 },
+    };
+
+    for (size_t s = 0; s < sizeof(shapes) / sizeof(shapes[0]); s++) {
+        int n = shapes[s][0], d = shapes[s][1], rank = shapes[s][2], k = shapes[s][3];
+        Matrix *X = make_data(n, d, rank, (s == 2) ? 0.0 : 1e-3);
+
+        PCAOptions ref_opts = pca_default_options();
+        ref_opts.eigen_solver = PCA_EIGEN_DENSE;
+        silence_stdout();
+        PCAModel *ref = pca_fit_with_options(X, k, &ref_opts);
+        restore_stdout();
+        CHECK(ref != NULL, "dense fit of %d x %d failed", n, d);
+        if (!ref) {
+            matrix_free(X);
+            continue;
+        }
+
+        EigenWorkspace *ws = eigen_workspace_create();
+        for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+            for (int threads = 1; threads <= 4; threads *= 4) {
+                for (int mode = 0; mode < 3; mode++) {     /* heap, arena, workspace */
+                    char label[128];
+                    snprintf(label, sizeof(label), "%s %d x %d k=%d, %d thread%s, %s",
+                             cases[c].name, n, d, k, threads, threads == 1 ? "" : "s",
+                             mode == 0 ? "heap" : mode == 1 ? "arena" : "workspace");
+
+                    PCAOptions opts = pca_default_options();
+                    opts.eigen_solver = cases[c].eigen_solver;
+                    opts.solver = cases[c].solver;
+                    opts.matrix_free = cases[c].matrix_free;
+                    opts.n_threads = threads;
+                    opts.oversample = d;        /* Full sketch: the randomized SVD is exact */
+
+                    PCAArena *arena = NULL;
+                    size_t need = 0;
+                    if (mode == 1) {
+                        need = pca_scratch_bytes(n, d, k, &opts);
+                        arena = pca_arena_create(need);
+                        opts.arena = arena;
+                    } else if (mode == 2) {
+                        opts.workspace = ws;
+                    }
+
+                    silence_stdout();
+                    PCAModel *model = pca_fit_with_options(X, k, &opts);
+                    Matrix *Y = model ? pca_transform_with_options(model, X, &opts) : NULL;
+                    restore_stdout();
+
+                    CHECK(model && Y, "%s: fit or transform failed", label);
+                    if (model) compare_models(ref, model, cases[c].tolerance, label);
+                    if (arena) {
+                        CHECK(arena->peak <= need, "%s: arena peak %zu over pca_scratch_bytes %zu",
+                              label, arena->peak, need);
+                    }
+
+                    matrix_free(Y);
+                    pca_free(model);
+                    pca_arena_free(arena);
+                }
+            }
+        }
+        eigen_workspace_free(ws);
+        pca_free(ref);
+        matrix_free(X);
+    }
+}
+
+int main(void) {
+    struct {
+        const char *name;
+        void (*run)(void);
+    } tests[] = {
+        { "number parsing", test_parse },
+        { "number formatting", test_format },
+        { "cross-solver comparison", test_solvers },
+    };
+
+    for (size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
+        int before_failures = failures;
+        int before_checks = checks;
+        tests[i].run();
+        printf("  %-26s %s (%d checks)\n", tests[i].name,
+               failures == before_failures ? "ok" : "FAILED", checks - before_checks);
+    }
+
+    printf("%s: %d of %d checks failed\n", failures ? "FAILED" : "PASSED", failures, checks);
+    return failures ? 1 : 0;
+}